@@ -0,0 +1,65 @@
+#!/bin/sh
+#
+# Benchmark for eopd.
+#
+# Runs eopd on fixed corpora of random triangulations and reports the
+# throughput for each corpus. The corpora are generated by
+# random_triangulation with a fixed seed, so the numbers are comparable
+# across commits. Each corpus is checked RUNS times and the fastest run
+# is reported.
+#
+# Usage: sh bench.sh [eopd options]
+#
+# The environment variables EOPD, GENERATOR, CORPUS_DIR and RUNS can be
+# used to override the defaults below.
+
+EOPD=${EOPD:-build/eopd}
+GENERATOR=${GENERATOR:-build/random_triangulation}
+CORPUS_DIR=${CORPUS_DIR:-build/bench}
+RUNS=${RUNS:-3}
+SEED=2014
+
+# vertices:graphs
+CORPORA="12:20000 20:10000 28:5000 34:5000"
+
+mkdir -p "$CORPUS_DIR"
+
+echo "# eopd benchmark (format 1, seed $SEED, best of $RUNS)"
+echo "# options: $*"
+printf "%4s %8s %9s %10s %12s %10s %8s\n" \
+    "n" "graphs" "uncovered" "seconds" "graphs/s" "ns/tuple" "hitrate"
+
+for corpus in $CORPORA; do
+    n=${corpus%%:*}
+    count=${corpus##*:}
+    file="$CORPUS_DIR/corpus_${n}_${count}_${SEED}.pc"
+    if [ ! -f "$file" ]; then
+        "$GENERATOR" -c "$count" -s "$SEED" "$n" > "$file" || exit 1
+    fi
+    best=""
+    run=0
+    while [ $run -lt "$RUNS" ]; do
+        stats=$("$EOPD" -t "$@" < "$file" 2>&1 > /dev/null) || exit 1
+        best=$(echo "$stats" | awk -v best="$best" '
+            $1 == "Read" { graphs = $2 }
+            $1 == "Written" { uncovered = $2 }
+            $1 == "Checked" { tuples += $2 }
+            /covered by a stored OPD/ { hits = $1 }
+            $1 == "Spent" { seconds = $2 }
+            END {
+                if (best != "") {
+                    split(best, b, " ")
+                    if (b[4] <= seconds) { print best; exit }
+                }
+                print graphs, uncovered, tuples, seconds, hits
+            }')
+        run=$((run + 1))
+    done
+    echo "$best" | awk -v n="$n" '{
+        graphs = $1; uncovered = $2; tuples = $3; seconds = $4; hits = $5
+        printf "%4d %8d %9d %10.4f %12.1f %10.1f %8.4f\n", n, graphs, uncovered,
+            seconds, (seconds > 0 ? graphs / seconds : 0),
+            (tuples > 0 ? seconds * 1e9 / tuples : 0),
+            (tuples > 0 ? hits / tuples : 0)
+    }'
+done
@@ -7,12 +7,14 @@
 
 /* This program reads plane triangulations from standard in and
  * checks whether each 4-tuple of faces contains 2 faces which
- * are contained in an extended outer planar disc.   
+ * are contained in an extended outer planar disc. Other tuple
+ * sizes can be chosen with the option -k. The triangulations can
+ * also be read from one or more files.
  * 
  * 
  * Compile with:
  *     
- *     cc -o eopd -O4 eopd.c
+ *     cc -o eopd -O4 -pthread eopd.c
  * 
  */
 
@@ -20,6 +22,17 @@
 #include <stdio.h>
 #include <getopt.h>
 #include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 
 
 #define MAXN 34            /* the maximum number of vertices */
@@ -27,10 +40,12 @@
 #define MAXF (2*MAXN-4)      /* the maximum number of faces */
 #define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
 #define MAXCODELENGTH (MAXN+MAXE+3)
-#define MAX_EOPD ((MAXF)*((MAXF)-1)*((MAXF)-2)/6) /*maybe too few: currently = #triples*/
 
 #define INFI (MAXN + 1)
 
+#define MIN_TUPLE_SIZE 3
+#define MAX_TUPLE_SIZE 6
+
 typedef int boolean;
 
 #define FALSE 0
@@ -44,6 +59,7 @@ typedef unsigned long long int bitset;
 #define SINGLETON(el) (ONE << (el))
 #define IS_SINGLETON(s) ((s) && (!((s) & ((s)-1))))
 #define HAS_MORE_THAN_ONE_ELEMENT(s) ((s) & ((s)-1))
+#define HAS_MORE_THAN_TWO_ELEMENTS(s) HAS_MORE_THAN_ONE_ELEMENT((s) & ((s)-1))
 #define IS_NOT_EMPTY(s) (s)
 #define IS_EMPTY(s) (!(s))
 #define CONTAINS(s, el) ((s) & SINGLETON(el))
@@ -60,6 +76,11 @@ typedef unsigned long long int bitset;
 //the following macros perform an extra step, but will work even if the element is not in the set
 #define SAFE_REMOVE(s, el) ADD(s, el); REMOVE(s, el)
 #define SAFE_REMOVE_ALL(s, elements) ADD_ALL(s, elements); REMOVE_ALL(s, elements)
+//this will only work if the set is not empty
+#define FIRST_ELEMENT(s) __builtin_ctzll(s)
+#define SIZE(s) __builtin_popcountll(s)
+//all elements larger than el
+#define ABOVE(el) ((el) >= 63 ? EMPTY_SET : (~ZERO) << ((el) + 1))
 
 
 typedef struct e /* The data type used for edges */ {
@@ -83,6 +104,11 @@ bitset neighbourhood[MAXN];
 EDGE *facestart[MAXF]; /* pointer to arbitrary edge of face i. */
 int faceSize[MAXF]; /* pointer to arbitrary edge of face i. */
 bitset faceSets[MAXF];
+bitset vertexFaces[MAXN]; /* faces that contain vertex i */
+bitset disjointFaces[MAXF]; /* faces that share no vertex with face i;
+                               note: only valid if computeDisjointFaces() called */
+unsigned char dualDistance[MAXF][MAXF]; /* distance between faces i and j in the dual;
+                                           note: only valid if goalDirected */
 
 EDGE edges[MAXE];
 
@@ -101,16 +127,94 @@ int nv;
 int ne;
 int nf;
 
-bitset opdFaces[MAX_EOPD];
-bitset extensionFaces[MAX_EOPD]; //all extensions for the OPD
-int eopdCount = 0;
+/* The stored OPD's are kept in arrays that grow when needed, and that are
+ * reused for the next graph. They are local to each thread, so the
+ * threads that count the uncovered tuples each grow their own set of
+ * OPD's, and keep it for the next graph.
+ */
+__thread bitset *opdFaces = NULL;
+__thread bitset *extensionFaces = NULL; //all extensions for the OPD
+__thread int eopdCount = 0;
+__thread int eopdCapacity = 0;
+__thread int lastStoredOpd; //the index of the OPD that was stored last
+boolean moveHitsToFront = FALSE; //move a stored OPD to the front when it covers a tuple
+/* The faces that form a covered pair with face i according to some stored
+ * OPD: the OPD faces and extension faces if face i is in the OPD, and the
+ * OPD faces if face i is an extension. An OPD that is evicted is still an
+ * OPD of the graph, so its pairs stay in these sets until the next graph.
+ */
+__thread bitset storedPartners[MAXF];
+
+//eviction of stored OPD's
+#define EVICT_LRU 0
+#define EVICT_FIFO 1
+
+int maximumStoredOpds = 0; //0 means no limit
+int evictionPolicy = EVICT_LRU;
+__thread int nextFifoVictim = 0;
+__thread unsigned long long int numberOfEvictedOpds = 0;
+__thread unsigned long long int numberOfDominatedOpds = 0; //removed because another OPD covers more
+
+bitset uncoveredTuple; //the last tuple for which no eOPD was found
+
+//relabelling of the faces
+#define RELABEL_NONE 0
+#define RELABEL_BFS 1
+#define RELABEL_DEGREE 2
+#define RELABEL_PARTNERS 3
+
+int relabelling = RELABEL_NONE;
+int originalFace[MAXF]; /* the label given by makeDual() to face i;
+                           note: only valid if relabelling is used */
+
+//certificates
+FILE *certificateFile = NULL;
+__thread bitset *certificateExtensions = NULL; //extension faces used with the stored OPD
+__thread boolean *certificateOpdOnly = NULL; //stored OPD used without extension
+
+//the eOPD's of the certificate whose OPD was evicted
+bitset *retiredCertificateOpds = NULL;
+int *retiredCertificateExtensions = NULL; //-1 if the OPD contains two faces of the tuple
+int retiredCertificateCount = 0;
+int retiredCertificateCapacity = 0;
 
 //statistics
-unsigned long long int numberOfTuplesCoveredByStoredOpd = 0;
-unsigned long long int numberOfChecked3Tuples = 0;
-unsigned long long int numberOfChecked4Tuples = 0;
+unsigned long long int numberOfGraphs = 0;
+unsigned long long int numberOfUncoveredGraphs = 0;
+__thread unsigned long long int numberOfTuplesCoveredByStoredOpd = 0;
+__thread unsigned long long int numberOfCheckedTuples[MAX_TUPLE_SIZE + 1]; //indexed by size
+__thread unsigned long long int numberOfEopdNodes = 0; //nodes in the search for new eOPD's
+__thread unsigned long long int numberOfPrunedNodes = 0; //nodes from which no remaining face is reachable
+//the statistics of the counting threads that are not yet added to those of the main thread
+unsigned long long int countedCheckedTuples[MAX_TUPLE_SIZE + 1];
+unsigned long long int countedTuplesCoveredByStoredOpd = 0;
+unsigned long long int countedEvictedOpds = 0;
+unsigned long long int countedDominatedOpds = 0;
+unsigned long long int countedEopdNodes = 0;
+unsigned long long int countedPrunedNodes = 0;
 int maximumOpdCount = 0;
 
+int tupleSize = 4; //the size of the tuples of faces that are checked
+boolean goalDirected = FALSE; //grow the eOPD's towards the nearest face of the tuple
+boolean lookahead = FALSE; //prune the eOPD search when no remaining face can be reached
+unsigned long long int numberOfIsomorphismCacheLookups = 0;
+unsigned long long int numberOfIsomorphismCacheHits = 0;
+
+//the number of start faces for the initial OPD's, 0 to grow them from uncovered faces
+int seedCount = 0;
+
+//budget per graph
+double timeBudget = 0.0; //in seconds, 0 means no limit
+unsigned long long int nodeBudget = 0; //0 means no limit
+boolean hasBudget = FALSE;
+unsigned long long int budgetNodeCount;
+boolean budgetExceeded;
+
+//progress reporting
+volatile sig_atomic_t progressRequested = FALSE;
+struct timespec runStart;
+struct timespec graphStart;
+
 //////////////////////////////////////////////////////////////////////////////
 
 ////////START DEBUGGING METHODS
@@ -167,54 +271,616 @@ void printVertexTuple(bitset tuple){
 
 ////////END DEBUGGING METHODS
 
-//some macros for the stack in the next method
-#define PUSH(stack, value) stack[top++] = (value)
-#define POP(stack) stack[--top];
-#define STACKISEMPTY top==0
-#define STACKISNOTEMPTY top>0
+//=============== Progress reporting ===========================
 
-void greedyExtendOpdAndStore(bitset currentOpdVertices, bitset currentOpdFaces){
+/* Returns the number of checked tuples of the main thread, including
+ * those that the counting threads already added for the current graph.
+ */
+unsigned long long int numberOfCheckedTuplesTotal(){
     int i;
-    int top;
-    EDGE *boundaryStack[MAXE];
+    unsigned long long int total = 0;
+    for(i = MIN_TUPLE_SIZE; i <= tupleSize; i++){
+        total += numberOfCheckedTuples[i] + __atomic_load_n(countedCheckedTuples + i, __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+double secondsSince(struct timespec *t, clockid_t clock){
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (now.tv_sec - t->tv_sec) + (now.tv_nsec - t->tv_nsec) / 1e9;
+}
+
+void requestProgress(int signal){
+    (void) signal;
+    progressRequested = TRUE;
+}
+
+/* Prints a single line with the progress of this run. This is called
+ * from the main loop and from the tuple search when a progress report
+ * was requested by the interval timer or by SIGUSR1, so it also shows
+ * up while we are stuck on a single hard graph.
+ */
+void printProgress(){
+    progressRequested = FALSE;
+    double elapsed = secondsSince(&runStart, CLOCK_MONOTONIC);
+    unsigned long long int tuples = numberOfCheckedTuplesTotal();
+    unsigned long long int tuplesCoveredByStoredOpd = numberOfTuplesCoveredByStoredOpd +
+            __atomic_load_n(&countedTuplesCoveredByStoredOpd, __ATOMIC_RELAXED);
+    fprintf(stderr, "Progress: %llu graph%s read (%.1f graphs/s), %llu uncovered, "
+            "hit rate %.4f, graph %llu running for %.3f s, %.1f s elapsed.\n",
+            numberOfGraphs, numberOfGraphs==1 ? "" : "s",
+            elapsed > 0 ? numberOfGraphs / elapsed : 0.0,
+            numberOfUncoveredGraphs,
+            tuples ? (double) tuplesCoveredByStoredOpd / tuples : 0.0,
+            numberOfGraphs + 1, secondsSince(&graphStart, CLOCK_MONOTONIC_COARSE),
+            elapsed);
+}
 
-    top = 0;
+void startProgressReporting(int interval){
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = requestProgress;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, NULL);
     
-    //fill the stack with the current boundary
-    for(i = 0; i < ne; i++){
-        if(CONTAINS_ALL(currentOpdVertices, edges[i].vertices) &&
-                !CONTAINS(currentOpdFaces, edges[i].rightface)){
-            PUSH(boundaryStack, edges + i);
-        }
+    if(interval > 0){
+        struct itimerval timer;
+        sigaction(SIGALRM, &action, NULL);
+        timer.it_interval.tv_sec = interval;
+        timer.it_interval.tv_usec = 0;
+        timer.it_value = timer.it_interval;
+        setitimer(ITIMER_REAL, &timer, NULL);
     }
+}
+
+//=============== Performance counters ===========================
+
+/* With --perf the hardware counters below are read whenever the program
+ * switches between the phases of the search, and the differences are
+ * attributed to the phase that just ended. The counters are opened as a
+ * single group, so they are scheduled together and read with a single
+ * system call, and they only count in user space, so the system calls
+ * for switching phases and for reading the input are not attributed.
+ */
+
+#define PERF_OFF 0
+#define PERF_RUN 1
+#define PERF_GRAPH 2
+
+#define PERF_PHASE_NONE -1
+#define PERF_PHASE_DECODE 0
+#define PERF_PHASE_SEEDING 1
+#define PERF_PHASE_LOOKUP 2
+#define PERF_PHASE_DFS 3
+#define PERF_PHASE_OUTPUT 4
+#define PERF_PHASES 5
+
+#define PERF_CYCLES 0
+#define PERF_INSTRUCTIONS 1
+#define PERF_BRANCH_MISSES 2
+#define PERF_L1D_MISSES 3
+#define PERF_LLC_MISSES 4
+#define PERF_EVENTS 5
+
+char *perfPhaseNames[PERF_PHASES] = {"decode", "seeding", "lookup", "dfs", "output"};
+
+int perfMode = PERF_OFF;
+int perfFds[PERF_EVENTS]; /* -1 for the events that are not available */
+int perfGroupIndex[PERF_EVENTS]; /* the position of each event in a group read */
+int perfGroupSize = 0;
+int currentPerfPhase = PERF_PHASE_NONE;
+unsigned long long int lastPerfValues[PERF_EVENTS];
+unsigned long long int perfCounts[PERF_PHASES][PERF_EVENTS];
+unsigned long long int graphPerfCounts[PERF_PHASES][PERF_EVENTS];
+unsigned long long int perfTimeEnabled, perfTimeRunning;
+
+int openPerfEvent(unsigned int type, unsigned long long int config, int groupFd){
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP |
+            PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+/* Opens and enables the counters. Returns FALSE if the cycle counter,
+ * which leads the group, cannot be opened. The other events are only
+ * reported if they are supported by this processor.
+ */
+boolean startPerfCounters(){
+    int i;
+    unsigned int types[PERF_EVENTS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE
+    };
+    unsigned long long int configs[PERF_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES
+    };
     
-    while(STACKISNOTEMPTY){
-        EDGE *currentEdge = POP(boundaryStack);
-        if(INTERSECTION(currentOpdVertices, neighbourhood[currentEdge->next->end])
-                == currentEdge->vertices){
-            //modify OPD by adding face to the right of current edge
-            ADD_ALL(currentOpdVertices, faceSets[currentEdge->rightface]);
-            ADD(currentOpdFaces, currentEdge->rightface);
-            
-            //push new boundary edges on stack
-            PUSH(boundaryStack, currentEdge->next);
-            PUSH(boundaryStack, currentEdge->inverse->prev->inverse);
+    perfFds[PERF_CYCLES] = openPerfEvent(types[PERF_CYCLES], configs[PERF_CYCLES], -1);
+    if(perfFds[PERF_CYCLES] == -1){
+        return FALSE;
+    }
+    perfGroupIndex[PERF_CYCLES] = perfGroupSize++;
+    for(i = PERF_CYCLES + 1; i < PERF_EVENTS; i++){
+        perfFds[i] = openPerfEvent(types[i], configs[i], perfFds[PERF_CYCLES]);
+        if(perfFds[i] != -1){
+            perfGroupIndex[i] = perfGroupSize++;
         }
     }
     
-    //store the OPD together with all possible extensions
-    opdFaces[eopdCount] = currentOpdFaces;
-    extensionFaces[eopdCount] = EMPTY_SET;
+    ioctl(perfFds[PERF_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perfFds[PERF_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return TRUE;
+}
+
+void readPerfCounters(unsigned long long int *values){
+    int i;
+    unsigned long long int buffer[3 + PERF_EVENTS];
+    if(read(perfFds[PERF_CYCLES], buffer, sizeof(buffer)) < (ssize_t)((3 + perfGroupSize) * sizeof(buffer[0]))){
+        return;
+    }
+    perfTimeEnabled = buffer[1];
+    perfTimeRunning = buffer[2];
+    for(i = 0; i < PERF_EVENTS; i++){
+        if(perfFds[i] != -1){
+            values[i] = buffer[3 + perfGroupIndex[i]];
+        }
+    }
+}
+
+/* Attributes the events since the previous switch to the current phase,
+ * and continues counting for the given phase.
+ */
+void switchPerfPhase(int phase){
+    int i;
+    if(perfMode == PERF_OFF || phase == currentPerfPhase){
+        return;
+    }
+    unsigned long long int values[PERF_EVENTS];
+    memcpy(values, lastPerfValues, sizeof(values));
+    readPerfCounters(values);
+    if(currentPerfPhase != PERF_PHASE_NONE){
+        for(i = 0; i < PERF_EVENTS; i++){
+            unsigned long long int delta = values[i] - lastPerfValues[i];
+            perfCounts[currentPerfPhase][i] += delta;
+            graphPerfCounts[currentPerfPhase][i] += delta;
+        }
+    }
+    memcpy(lastPerfValues, values, sizeof(values));
+    currentPerfPhase = phase;
+}
+
+void printPerfCount(char *name, unsigned long long int *counts){
+    int i;
+    fprintf(stderr, "%-10s", name);
+    for(i = 0; i < PERF_EVENTS; i++){
+        if(perfFds[i] == -1){
+            fprintf(stderr, " %14s", "n/a");
+        } else {
+            fprintf(stderr, " %14llu", counts[i]);
+        }
+        if(i == PERF_INSTRUCTIONS){
+            if(counts[PERF_CYCLES] && perfFds[PERF_INSTRUCTIONS] != -1){
+                fprintf(stderr, " %6.2f", (double) counts[PERF_INSTRUCTIONS] / counts[PERF_CYCLES]);
+            } else {
+                fprintf(stderr, " %6s", "n/a");
+            }
+        }
+    }
+    fprintf(stderr, "\n");
+}
+
+void printPerfHeader(char *title){
+    fprintf(stderr, "%-10s %14s %14s %6s %14s %14s %14s\n", title,
+            "cycles", "instructions", "IPC", "branch-misses", "L1d-misses", "LLC-misses");
+}
+
+/* Ends the counting for the current graph, and prints its counts with
+ * --perf=graph.
+ */
+void finishGraphPerf(unsigned long long int graph){
+    int i;
+    switchPerfPhase(PERF_PHASE_NONE);
+    if(perfMode == PERF_GRAPH){
+        char title[32];
+        snprintf(title, sizeof(title), "Graph %llu", graph);
+        printPerfHeader(title);
+        for(i = 0; i < PERF_PHASES; i++){
+            printPerfCount(perfPhaseNames[i], graphPerfCounts[i]);
+        }
+    }
+    memset(graphPerfCounts, 0, sizeof(graphPerfCounts));
+}
+
+void printPerfCounters(){
+    int i, j;
+    unsigned long long int total[PERF_EVENTS] = {0};
+    switchPerfPhase(PERF_PHASE_NONE);
+    fprintf(stderr, "Hardware counters per phase (user space only):\n");
+    printPerfHeader("phase");
+    for(i = 0; i < PERF_PHASES; i++){
+        printPerfCount(perfPhaseNames[i], perfCounts[i]);
+        for(j = 0; j < PERF_EVENTS; j++){
+            total[j] += perfCounts[i][j];
+        }
+    }
+    printPerfCount("total", total);
+    if(perfTimeRunning < perfTimeEnabled){
+        fprintf(stderr, "The counters were only scheduled %.1f%% of the time; "
+                "the counts are not scaled.\n",
+                perfTimeEnabled ? 100.0 * perfTimeRunning / perfTimeEnabled : 0.0);
+    }
+}
+
+//=============== Budget per graph ===========================
+
+/* Counts a node of the search for the current graph and checks whether
+ * the budget for this graph is exhausted. The clock is only read once
+ * every 1024 nodes.
+ */
+boolean isBudgetExceeded(){
+    budgetNodeCount++;
+    if(nodeBudget && budgetNodeCount > nodeBudget){
+        budgetExceeded = TRUE;
+    } else if(timeBudget > 0.0 && !(budgetNodeCount & 1023) &&
+            secondsSince(&graphStart, CLOCK_MONOTONIC_COARSE) > timeBudget){
+        budgetExceeded = TRUE;
+    }
+    return budgetExceeded;
+}
+
+//=============== Stored OPD's ===========================
+
+void *growArray(void *array, int capacity, size_t size){
+    array = realloc(array, capacity * size);
+    if(array == NULL){
+        fprintf(stderr, "Insufficient memory for the stored OPD's -- exiting!\n");
+        exit(1);
+    }
+    return array;
+}
+
+/* Makes sure that there is room for at least one more stored OPD.
+ */
+void ensureStoredOpdCapacity(){
+    if(eopdCount < eopdCapacity){
+        return;
+    }
+    eopdCapacity = eopdCapacity ? 2*eopdCapacity : 64;
+    opdFaces = growArray(opdFaces, eopdCapacity, sizeof(bitset));
+    extensionFaces = growArray(extensionFaces, eopdCapacity, sizeof(bitset));
+    if(certificateFile != NULL){
+        certificateExtensions = growArray(certificateExtensions, eopdCapacity, sizeof(bitset));
+        certificateOpdOnly = growArray(certificateOpdOnly, eopdCapacity, sizeof(boolean));
+    }
+}
+
+void freeStoredOpds(){
+    free(opdFaces);
+    free(extensionFaces);
+    free(certificateExtensions);
+    free(certificateOpdOnly);
+    opdFaces = extensionFaces = certificateExtensions = NULL;
+    certificateOpdOnly = NULL;
+    eopdCapacity = eopdCount = 0;
+}
+
+void retireCertificateEopd(bitset opd, int extension){
+    if(retiredCertificateCount == retiredCertificateCapacity){
+        retiredCertificateCapacity = retiredCertificateCapacity ? 2*retiredCertificateCapacity : 64;
+        retiredCertificateOpds = growArray(retiredCertificateOpds,
+                retiredCertificateCapacity, sizeof(bitset));
+        retiredCertificateExtensions = growArray(retiredCertificateExtensions,
+                retiredCertificateCapacity, sizeof(int));
+    }
+    retiredCertificateOpds[retiredCertificateCount] = opd;
+    retiredCertificateExtensions[retiredCertificateCount] = extension;
+    retiredCertificateCount++;
+}
+
+/* Exchanges stored OPD i with the first stored OPD.
+ */
+void moveStoredOpdToFront(int i){
+    bitset opd = opdFaces[i];
+    bitset extensions = extensionFaces[i];
+    opdFaces[i] = opdFaces[0];
+    extensionFaces[i] = extensionFaces[0];
+    opdFaces[0] = opd;
+    extensionFaces[0] = extensions;
+    if(certificateFile != NULL){
+        bitset certificateExtension = certificateExtensions[i];
+        boolean opdOnly = certificateOpdOnly[i];
+        certificateExtensions[i] = certificateExtensions[0];
+        certificateOpdOnly[i] = certificateOpdOnly[0];
+        certificateExtensions[0] = certificateExtension;
+        certificateOpdOnly[0] = opdOnly;
+    }
+}
+
+/* Moves the eOPD's of stored OPD i that are used in the certificate to
+ * the retired eOPD's of the certificate, before the OPD is removed.
+ */
+void retireStoredOpd(int i){
+    int j;
+    if(certificateFile == NULL){
+        return;
+    }
+    if(certificateOpdOnly[i]){
+        retireCertificateEopd(opdFaces[i], -1);
+    }
+    for(j = 0; j < nf; j++){
+        if(CONTAINS(certificateExtensions[i], j)){
+            retireCertificateEopd(opdFaces[i], j);
+        }
+    }
+}
+
+void copyStoredOpd(int from, int to){
+    opdFaces[to] = opdFaces[from];
+    extensionFaces[to] = extensionFaces[from];
+    if(certificateFile != NULL){
+        certificateExtensions[to] = certificateExtensions[from];
+        certificateOpdOnly[to] = certificateOpdOnly[from];
+    }
+}
+
+/* Chooses a stored OPD that can be replaced by a new one. If the OPD was
+ * used in the certificate, its eOPD's are moved to the retired eOPD's of
+ * the certificate. With the LRU policy the OPD's that cover a tuple are
+ * moved to the front, so the last OPD is the one that is evicted.
+ */
+int evictStoredOpd(){
+    int victim;
+    if(evictionPolicy == EVICT_FIFO){
+        if(nextFifoVictim >= eopdCount){
+            nextFifoVictim = 0;
+        }
+        victim = nextFifoVictim;
+        nextFifoVictim = (nextFifoVictim + 1) % eopdCount;
+    } else {
+        victim = eopdCount - 1;
+    }
+    retireStoredOpd(victim);
+    numberOfEvictedOpds++;
+    return victim;
+}
+
+/* Returns TRUE if stored OPD i covers all tuples that are covered by the
+ * OPD opd with the extensions in extensions.
+ */
+boolean coversAllTuples(int i, bitset opd, bitset extensions){
+    return CONTAINS_ALL(opdFaces[i], opd) &&
+            CONTAINS_ALL(UNION(opdFaces[i], extensionFaces[i]), extensions);
+}
+
+/* Removes the stored OPD's that cover no tuple that is not also covered
+ * by the OPD opd with the extensions in extensions. The order of the
+ * other stored OPD's is kept.
+ */
+void removeDominatedOpds(bitset opd, bitset extensions){
+    int i;
+    int count = 0;
+    for(i = 0; i < eopdCount; i++){
+        if(CONTAINS_ALL(opd, opdFaces[i]) &&
+                CONTAINS_ALL(UNION(opd, extensions), extensionFaces[i])){
+            retireStoredOpd(i);
+            continue;
+        }
+        if(count < i){
+            copyStoredOpd(i, count);
+        }
+        count++;
+    }
+    numberOfDominatedOpds += eopdCount - count;
+    eopdCount = count;
+}
+
+/* Adds the pairs covered by stored OPD i to the partners of its faces.
+ */
+void addStoredPartners(int i){
+    int j;
+    bitset opdOrExtension = UNION(opdFaces[i], extensionFaces[i]);
+    for(j = 0; j < nf; j++){
+        if(CONTAINS(opdFaces[i], j)){
+            ADD_ALL(storedPartners[j], opdOrExtension);
+        } else if(CONTAINS(extensionFaces[i], j)){
+            ADD_ALL(storedPartners[j], opdFaces[i]);
+        }
+    }
+}
+
+/* Returns the faces that form a covered tuple together with the faces in
+ * tuple according to the stored OPD's, or all faces if tuple itself is
+ * already covered.
+ */
+bitset storedPartnersOfTuple(bitset tuple){
+    bitset partners = EMPTY_SET;
+    bitset faces = tuple;
+    while(IS_NOT_EMPTY(faces)){
+        int i = FIRST_ELEMENT(faces);
+        REMOVE(faces, i);
+        if(IS_NOT_EMPTY(INTERSECTION(storedPartners[i], MINUS(tuple, i)))){
+            return ~ZERO;
+        }
+        ADD_ALL(partners, storedPartners[i]);
+    }
+    return partners;
+}
+
+/* Removes all stored OPD's of this thread before starting with a new
+ * graph. The arrays are kept, so they are reused for the next graph.
+ */
+void clearStoredOpds(){
+    int i;
     for(i = 0; i < nf; i++){
-        if(!CONTAINS(currentOpdFaces, i) &&
-                HAS_MORE_THAN_ONE_ELEMENT(INTERSECTION(faceSets[i], currentOpdVertices))){
-            ADD(extensionFaces[eopdCount], i);
+        storedPartners[i] = EMPTY_SET;
+    }
+    eopdCount = 0;
+    nextFifoVictim = 0;
+}
+
+/* Grows the OPD as long as possible and stores it together with all its
+ * extensions. A face can be added to the OPD if its third vertex lies
+ * outside the OPD and has no neighbours in the OPD other than the two
+ * vertices of the face. Only the neighbours of an added vertex can become
+ * addable, so these are the only vertices that are checked again. The
+ * faces with at least two vertices in the OPD are kept up to date while
+ * growing: they are the new faces and, at the end, the extensions.
+ */
+void greedyExtendOpdAndStore(bitset currentOpdVertices, bitset currentOpdFaces){
+    int v;
+    bitset touchedFaces = EMPTY_SET; //faces with at least one vertex in the OPD
+    bitset incidentFaces = EMPTY_SET; //faces with at least two vertices in the OPD
+    bitset uncheckedVertices = EMPTY_SET;
+    
+    bitset vertices = currentOpdVertices;
+    while(IS_NOT_EMPTY(vertices)){
+        v = FIRST_ELEMENT(vertices);
+        REMOVE(vertices, v);
+        ADD_ALL(incidentFaces, INTERSECTION(touchedFaces, vertexFaces[v]));
+        ADD_ALL(touchedFaces, vertexFaces[v]);
+        ADD_ALL(uncheckedVertices, neighbourhood[v]);
+    }
+    uncheckedVertices &= ~currentOpdVertices;
+    
+    while(IS_NOT_EMPTY(uncheckedVertices)){
+        v = FIRST_ELEMENT(uncheckedVertices);
+        REMOVE(uncheckedVertices, v);
+        bitset opdNeighbours = INTERSECTION(neighbourhood[v], currentOpdVertices);
+        if(!HAS_MORE_THAN_ONE_ELEMENT(opdNeighbours) || HAS_MORE_THAN_TWO_ELEMENTS(opdNeighbours)){
+            continue;
+        }
+        //the face containing v and its two neighbours in the OPD
+        bitset newFace = INTERSECTION(vertexFaces[v], incidentFaces);
+        if(IS_EMPTY(newFace)){
+            continue;
+        }
+        ADD(currentOpdVertices, v);
+        ADD_ALL(currentOpdFaces, newFace);
+        ADD_ALL(incidentFaces, INTERSECTION(touchedFaces, vertexFaces[v]));
+        ADD_ALL(touchedFaces, vertexFaces[v]);
+        ADD_ALL(uncheckedVertices, INTERSECTION(neighbourhood[v], ~currentOpdVertices));
+    }
+    
+    bitset currentExtensionFaces = INTERSECTION(incidentFaces, ~currentOpdFaces);
+    
+    //a stored OPD that covers everything the new OPD covers is used instead
+    int index;
+    for(index = 0; index < eopdCount; index++){
+        if(coversAllTuples(index, currentOpdFaces, currentExtensionFaces)){
+            break;
+        }
+    }
+    if(index < eopdCount){
+        numberOfDominatedOpds++;
+    } else {
+        //store the OPD together with all possible extensions
+        removeDominatedOpds(currentOpdFaces, currentExtensionFaces);
+        if(maximumStoredOpds && eopdCount >= maximumStoredOpds){
+            index = evictStoredOpd();
+        } else {
+            ensureStoredOpdCapacity();
+            index = eopdCount++;
         }
+        if(certificateFile != NULL){
+            certificateExtensions[index] = EMPTY_SET;
+            certificateOpdOnly[index] = FALSE;
+        }
+        opdFaces[index] = currentOpdFaces;
+        extensionFaces[index] = currentExtensionFaces;
+        addStoredPartners(index);
+    }
+    if(moveHitsToFront && index > 0){
+        //the new OPD covers a tuple
+        moveStoredOpdToFront(index);
+        index = 0;
+    }
+    lastStoredOpd = index;
+}
+
+/* Returns the distance in the dual from face to the nearest face in faces.
+ */
+static inline int distanceToFaces(int face, bitset faces){
+    int distance = MAXF;
+    while(IS_NOT_EMPTY(faces)){
+        int i = FIRST_ELEMENT(faces);
+        REMOVE(faces, i);
+        if(dualDistance[face][i] < distance){
+            distance = dualDistance[face][i];
+        }
+    }
+    return distance;
+}
+
+/* Returns FALSE if the eOPD with the vertices in eopdVertices can no
+ * longer be grown from its last face to one of the faces in targetFaces.
+ * Each face that is added contains a new vertex which is adjacent to a
+ * vertex of the last face or to an earlier new vertex, and which has at
+ * most two neighbours in the eOPD. So all new vertices lie in the part of
+ * the graph outside the eOPD that can be reached from the last face
+ * through such vertices, and a face in targetFaces can only be added if
+ * it has a vertex in that part.
+ */
+static inline boolean canStillReachFaces(bitset eopdVertices, int lastFace, bitset targetFaces){
+    int v;
+    bitset targetVertices = EMPTY_SET;
+    while(IS_NOT_EMPTY(targetFaces)){
+        v = FIRST_ELEMENT(targetFaces);
+        REMOVE(targetFaces, v);
+        ADD_ALL(targetVertices, faceSets[v]);
+    }
+    
+    bitset candidates = EMPTY_SET;
+    bitset lastFaceVertices = faceSets[lastFace];
+    while(IS_NOT_EMPTY(lastFaceVertices)){
+        v = FIRST_ELEMENT(lastFaceVertices);
+        REMOVE(lastFaceVertices, v);
+        ADD_ALL(candidates, neighbourhood[v]);
+    }
+    
+    bitset visited = eopdVertices; //the vertices that were already considered
+    bitset frontier = EMPTY_SET;
+    while(TRUE){
+        candidates &= ~visited;
+        ADD_ALL(visited, candidates);
+        while(IS_NOT_EMPTY(candidates)){
+            v = FIRST_ELEMENT(candidates);
+            REMOVE(candidates, v);
+            if(!HAS_MORE_THAN_TWO_ELEMENTS(INTERSECTION(neighbourhood[v], eopdVertices))){
+                if(CONTAINS(targetVertices, v)){
+                    return TRUE;
+                }
+                ADD(frontier, v);
+            }
+        }
+        if(IS_EMPTY(frontier)){
+            return FALSE;
+        }
+        v = FIRST_ELEMENT(frontier);
+        REMOVE(frontier, v);
+        candidates = neighbourhood[v];
     }
-    eopdCount++;
 }
 
 boolean findEOPD_impl(bitset currentEopdVertices, bitset currentEopdFaces, int eopdExtension, bitset remainingFaces, EDGE *lastExtendedEdge){
+    if(hasBudget && isBudgetExceeded()){
+        //give up: the caller will notice that the budget is exceeded
+        return FALSE;
+    }
+    numberOfEopdNodes++;
+    
     //first check whether this is a covering eOPD
     if(IS_NOT_EMPTY(INTERSECTION(currentEopdFaces, remainingFaces))){
         //store the eOPD
@@ -222,36 +888,131 @@ boolean findEOPD_impl(bitset currentEopdVertices, bitset currentEopdFaces, int e
         return TRUE;
     }
     
+    //then check whether one of the remaining faces can still be reached
+    if(lookahead && !canStillReachFaces(currentEopdVertices, lastExtendedEdge->rightface, remainingFaces)){
+        numberOfPrunedNodes++;
+        return FALSE;
+    }
+    
     //otherwise try extending the eOPD
-    EDGE *extension = lastExtendedEdge->next;
+    EDGE *extensions[2];
+    int count = 0;
     
+    EDGE *extension = lastExtendedEdge->next;
     if(INTERSECTION(currentEopdVertices, neighbourhood[extension->next->end]) ==
             extension->vertices){
-            //face to the right of extension is addable
-            if(findEOPD_impl(UNION(currentEopdVertices, faceSets[extension->rightface]),
-                    UNION(currentEopdFaces, SINGLETON(extension->rightface)),
-                    eopdExtension, remainingFaces, extension)){
-                return TRUE;
-            }
+        //face to the right of extension is addable
+        extensions[count++] = extension;
     }
     
     extension = lastExtendedEdge->inverse->prev->inverse;
-    
     if(INTERSECTION(currentEopdVertices, neighbourhood[extension->next->end]) ==
             extension->vertices){
-            //face to the right of extension is addable
-            if(findEOPD_impl(UNION(currentEopdVertices, faceSets[extension->rightface]),
-                    UNION(currentEopdFaces, SINGLETON(extension->rightface)),
-                    eopdExtension, remainingFaces, extension)){
+        //face to the right of extension is addable
+        extensions[count++] = extension;
+    }
+    
+    //first grow towards the nearest remaining face
+    if(goalDirected && count == 2 &&
+            distanceToFaces(extensions[1]->rightface, remainingFaces) <
+            distanceToFaces(extensions[0]->rightface, remainingFaces)){
+        extension = extensions[0];
+        extensions[0] = extensions[1];
+        extensions[1] = extension;
+    }
+    
+    int i;
+    for(i = 0; i < count; i++){
+        extension = extensions[i];
+        if(findEOPD_impl(UNION(currentEopdVertices, faceSets[extension->rightface]),
+                UNION(currentEopdFaces, SINGLETON(extension->rightface)),
+                eopdExtension, remainingFaces, extension)){
+            return TRUE;
+        }
+    }
+    
+    return FALSE;
+}
+
+/* Marks the eOPD in stored OPD i that covers the tuple as part of the
+ * certificate for the current graph.
+ */
+void addToCertificate(int i, bitset tuple){
+    if(HAS_MORE_THAN_ONE_ELEMENT(INTERSECTION(tuple, opdFaces[i]))){
+        certificateOpdOnly[i] = TRUE;
+    } else {
+        ADD(certificateExtensions[i],
+                FIRST_ELEMENT(INTERSECTION(tuple, extensionFaces[i])));
+    }
+}
+
+/* Searches a new eOPD for the tuple, without looking at the stored OPD's.
+ * If one is found, it is extended and stored at index lastStoredOpd. If
+ * goalDirected is set, the faces that are closest to another face of the
+ * tuple are tried first as extension, and for each of them the shared
+ * edges are tried in order of the distance from the neighbouring face to
+ * the other faces. Otherwise both are tried in the order of their labels.
+ */
+boolean findNewEOPD(bitset tuple){
+    int i, j, k, l;
+    int extensionOrder[MAX_TUPLE_SIZE];
+    int distances[MAX_TUPLE_SIZE];
+    int count = 0;
+    
+    bitset faces = tuple;
+    while(IS_NOT_EMPTY(faces)){
+        i = FIRST_ELEMENT(faces);
+        REMOVE(faces, i);
+        int distance = goalDirected ? distanceToFaces(i, MINUS(tuple, i)) : 0;
+        for(j = count++; j > 0 && distances[j-1] > distance; j--){
+            extensionOrder[j] = extensionOrder[j-1];
+            distances[j] = distances[j-1];
+        }
+        extensionOrder[j] = i;
+        distances[j] = distance;
+    }
+    
+    for(k = 0; k < count; k++){
+        //try to find a eOPD with face i as extension
+        i = extensionOrder[k];
+        bitset remainingFaces = MINUS(tuple, i);
+        
+        //we use each edge once as a possible shared edge
+        EDGE *sharedEdges[3];
+        int sharedEdgeDistances[3];
+        EDGE *sharedEdge = facestart[i];
+        for(l = 0; l < 3; l++){
+            int distance = goalDirected ?
+                    distanceToFaces(sharedEdge->inverse->rightface, remainingFaces) : 0;
+            for(j = l; j > 0 && sharedEdgeDistances[j-1] > distance; j--){
+                sharedEdges[j] = sharedEdges[j-1];
+                sharedEdgeDistances[j] = sharedEdgeDistances[j-1];
+            }
+            sharedEdges[j] = sharedEdge;
+            sharedEdgeDistances[j] = distance;
+            sharedEdge = sharedEdge->next->inverse;
+        }
+        
+        for(j = 0; j < 3; j++){
+            //construct initial eopd
+            sharedEdge = sharedEdges[j];
+            int neighbouringFace = sharedEdge->inverse->rightface;
+            bitset currentEopdVertices = faceSets[neighbouringFace];
+            bitset currentEopdFaces = UNION(SINGLETON(i), SINGLETON(neighbouringFace));
+            if(findEOPD_impl(currentEopdVertices, currentEopdFaces, i, remainingFaces, sharedEdge->inverse)){
+                //the new eOPD was extended and stored
+                if(certificateFile != NULL){
+                    addToCertificate(lastStoredOpd, tuple);
+                }
                 return TRUE;
             }
+        }
     }
-    
     return FALSE;
 }
 
 boolean findEOPD(bitset tuple){
-    int i, j;
+    int i;
     //first we check the stored OPD's
     for(i = 0; i < eopdCount; i++){
         bitset intersectionOpd = INTERSECTION(tuple, opdFaces[i]);
@@ -259,187 +1020,1292 @@ boolean findEOPD(bitset tuple){
         if((IS_NOT_EMPTY(intersectionOpd) && IS_NOT_EMPTY(intersectionExtensions)) ||
                 (HAS_MORE_THAN_ONE_ELEMENT(intersectionOpd))){
             numberOfTuplesCoveredByStoredOpd++;
+            if(certificateFile != NULL){
+                addToCertificate(i, tuple);
+            }
+            if(moveHitsToFront && i > 0){
+                moveStoredOpdToFront(i);
+            }
             return TRUE;
         }
     }
     
     //then we try to find a new eOPD
-    for(i = 0; i < nf; i++){
-        if(CONTAINS(tuple, i)){
-            //try to find a eOPD with face i as extension
-            bitset remainingFaces = MINUS(tuple, i);
-            //we use each edge once as a possible shared edge 
-            EDGE *sharedEdge = facestart[i];
-            for(j = 0; j < 3; j++){
-                //construct initial eopd
-                int neighbouringFace = sharedEdge->inverse->rightface;
-                bitset currentEopdVertices = faceSets[neighbouringFace];
-                bitset currentEopdFaces = UNION(SINGLETON(i), SINGLETON(neighbouringFace));
-                if(findEOPD_impl(currentEopdVertices, currentEopdFaces, i, remainingFaces, sharedEdge->inverse)){
-                    return TRUE;
-                }
-                sharedEdge = sharedEdge->next->inverse;
+    switchPerfPhase(PERF_PHASE_DFS);
+    boolean found = findNewEOPD(tuple);
+    switchPerfPhase(PERF_PHASE_LOOKUP);
+    return found;
+}
+
+/* The search for an uncovered k-tuple is specialized at compile time for
+ * each supported k: the macros below define one function per level of
+ * the search, named findUncoveredFaceTuple_<k>_<size>, so the levels are
+ * unrolled and there are no runtime checks on the size of the tuple.
+ * Tuples of size 1 and 2 are just extended. From size 3 on, each tuple
+ * is first checked for an eOPD: if one is found, all its extensions are
+ * covered as well. The tuples of size k-1 are not extended face by face:
+ * all their extensions are resolved at once by findUncoveredLastFace().
+ */
+
+/* Checks all tuples that consist of the faces in tuple together with a
+ * face with index at least position that shares no vertex with them. The
+ * faces that form a covered tuple according to the stored OPD's are
+ * removed all at once, and only for the remaining faces a new eOPD is
+ * searched.
+ */
+boolean findUncoveredLastFace(bitset tuple, bitset tupleVertices, int position){
+    int i;
+    bitset candidates = EMPTY_SET;
+    
+    if(budgetExceeded){
+        //stop the search: the graph will be deferred
+        return TRUE;
+    }
+    if(progressRequested){
+        printProgress();
+    }
+    for(i = position; i < nf; i++){
+        if(IS_EMPTY(INTERSECTION(tupleVertices, faceSets[i]))){
+            ADD(candidates, i);
+        }
+    }
+    numberOfCheckedTuples[tupleSize] += SIZE(candidates);
+    
+    if(certificateFile != NULL){
+        //the stored OPD that covers each tuple is needed for the certificate
+        while(IS_NOT_EMPTY(candidates)){
+            i = FIRST_ELEMENT(candidates);
+            REMOVE(candidates, i);
+            if(!findEOPD(UNION(tuple, SINGLETON(i)))){
+                uncoveredTuple = UNION(tuple, SINGLETON(i));
+                return TRUE;
             }
         }
+        return FALSE;
+    }
+    
+    bitset remaining = candidates & ~storedPartnersOfTuple(tuple);
+    numberOfTuplesCoveredByStoredOpd += SIZE(candidates) - SIZE(remaining);
+    while(IS_NOT_EMPTY(remaining)){
+        i = FIRST_ELEMENT(remaining);
+        REMOVE(remaining, i);
+        switchPerfPhase(PERF_PHASE_DFS);
+        boolean found = findNewEOPD(UNION(tuple, SINGLETON(i)));
+        switchPerfPhase(PERF_PHASE_LOOKUP);
+        if(!found){
+            //the tuples with a later last face were not checked
+            bitset laterCandidates = INTERSECTION(candidates, ABOVE(i));
+            numberOfCheckedTuples[tupleSize] -= SIZE(laterCandidates);
+            numberOfTuplesCoveredByStoredOpd -= SIZE(laterCandidates) - SIZE(remaining);
+            uncoveredTuple = UNION(tuple, SINGLETON(i));
+            return TRUE;
+        }
+        //the new OPD might cover some of the remaining tuples
+        bitset stillRemaining = remaining & ~storedPartnersOfTuple(tuple);
+        numberOfTuplesCoveredByStoredOpd += SIZE(remaining) - SIZE(stillRemaining);
+        remaining = stillRemaining;
     }
     return FALSE;
 }
 
-boolean findUncoveredFaceTuple_impl(bitset tuple, bitset tupleVertices, int position, int size){
-    if(size + (nf - position) < 4){
-        //this tuple can't be completed to a 4-tuple
-        return FALSE;
+#define EXTEND_TUPLE_BY_ONE_FACE(k, size) \
+    int i; \
+    for(i = position; i < nf - (k) + (size) + 1; i++){ \
+        if(IS_EMPTY(INTERSECTION(tupleVertices, faceSets[i]))){ \
+            if(findUncoveredFaceTuple_##k##_##size##_next(UNION(tuple, SINGLETON(i)), \
+                UNION(tupleVertices, faceSets[i]), i+1)){ \
+                return TRUE; \
+            } \
+        } \
     }
-    if(size < 3){
-        //just extend and continue
-        int i;
-        for(i = position; i < nf - 3 + size; i++){
-            if(IS_EMPTY(INTERSECTION(tupleVertices, faceSets[i]))){
-                if(findUncoveredFaceTuple_impl(UNION(tuple, SINGLETON(i)),
-                    UNION(tupleVertices, faceSets[i]), i+1, size+1)){
-                    return TRUE;
-                }
-            }
-        }
-    } else if(size == 3){
-        //search for eOPD and if none found: go to 4-tuple
-        numberOfChecked3Tuples++;
-        if(findEOPD(tuple)){
-            return FALSE;
-        }
-        //no eOPD found: extending tuple
-        int i;
-        for(i = position; i < nf; i++){
-            if(IS_EMPTY(INTERSECTION(tupleVertices, faceSets[i]))){
-                if(findUncoveredFaceTuple_impl(UNION(tuple, SINGLETON(i)),
-                    UNION(tupleVertices, faceSets[i]), i+1, size+1)){
-                    return TRUE;
+
+#define EXTEND_TUPLE_BY_LAST_FACE(k, size) \
+    if(findUncoveredLastFace(tuple, tupleVertices, position)){ \
+        return TRUE; \
+    }
+
+//tuples of this size are extended without checking them
+#define DEFINE_EXTEND_LEVEL(k, size, EXTEND_TUPLE) \
+boolean findUncoveredFaceTuple_##k##_##size(bitset tuple, bitset tupleVertices, int position){ \
+    if(budgetExceeded){ \
+        /*stop the search: the graph will be deferred*/ \
+        return TRUE; \
+    } \
+    EXTEND_TUPLE(k, size) \
+    return FALSE; \
+}
+
+//tuples of this size are checked, and only extended if no eOPD is found
+#define DEFINE_CHECK_LEVEL(k, size, EXTEND_TUPLE) \
+boolean findUncoveredFaceTuple_##k##_##size(bitset tuple, bitset tupleVertices, int position){ \
+    if(budgetExceeded){ \
+        /*stop the search: the graph will be deferred*/ \
+        return TRUE; \
+    } \
+    numberOfCheckedTuples[size]++; \
+    if(progressRequested){ \
+        printProgress(); \
+    } \
+    if(findEOPD(tuple)){ \
+        return FALSE; \
+    } \
+    /*no eOPD found: extending tuple*/ \
+    EXTEND_TUPLE(k, size) \
+    /*if we get here then all tuples extending the current tuple were covered*/ \
+    return FALSE; \
+}
+
+//the search over all tuples, starting with each possible first face
+#define DEFINE_SEARCH(k) \
+boolean findUncoveredFaceTuple_##k(){ \
+    int i; \
+    for(i = 0; i < nf - (k) + 1; i++){ \
+        if(findUncoveredFaceTuple_##k##_1(SINGLETON(i), faceSets[i], i + 1)){ \
+            return TRUE; \
+        } \
+    } \
+    return FALSE; \
+}
+
+#define findUncoveredFaceTuple_3_1_next findUncoveredFaceTuple_3_2
+DEFINE_EXTEND_LEVEL(3, 2, EXTEND_TUPLE_BY_LAST_FACE)
+DEFINE_EXTEND_LEVEL(3, 1, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_SEARCH(3)
+
+#define findUncoveredFaceTuple_4_1_next findUncoveredFaceTuple_4_2
+#define findUncoveredFaceTuple_4_2_next findUncoveredFaceTuple_4_3
+DEFINE_CHECK_LEVEL(4, 3, EXTEND_TUPLE_BY_LAST_FACE)
+DEFINE_EXTEND_LEVEL(4, 2, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_EXTEND_LEVEL(4, 1, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_SEARCH(4)
+
+#define findUncoveredFaceTuple_5_1_next findUncoveredFaceTuple_5_2
+#define findUncoveredFaceTuple_5_2_next findUncoveredFaceTuple_5_3
+#define findUncoveredFaceTuple_5_3_next findUncoveredFaceTuple_5_4
+DEFINE_CHECK_LEVEL(5, 4, EXTEND_TUPLE_BY_LAST_FACE)
+DEFINE_CHECK_LEVEL(5, 3, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_EXTEND_LEVEL(5, 2, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_EXTEND_LEVEL(5, 1, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_SEARCH(5)
+
+#define findUncoveredFaceTuple_6_1_next findUncoveredFaceTuple_6_2
+#define findUncoveredFaceTuple_6_2_next findUncoveredFaceTuple_6_3
+#define findUncoveredFaceTuple_6_3_next findUncoveredFaceTuple_6_4
+#define findUncoveredFaceTuple_6_4_next findUncoveredFaceTuple_6_5
+DEFINE_CHECK_LEVEL(6, 5, EXTEND_TUPLE_BY_LAST_FACE)
+DEFINE_CHECK_LEVEL(6, 4, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_CHECK_LEVEL(6, 3, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_EXTEND_LEVEL(6, 2, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_EXTEND_LEVEL(6, 1, EXTEND_TUPLE_BY_ONE_FACE)
+DEFINE_SEARCH(6)
+
+void computeDisjointFaces(){
+    int i, j;
+    for(i = 0; i < nf; i++){
+        disjointFaces[i] = EMPTY_SET;
+        for(j = 0; j < nf; j++){
+            if(IS_EMPTY(INTERSECTION(faceSets[i], faceSets[j]))){
+                ADD(disjointFaces[i], j);
+            }
+        }
+    }
+}
+
+/* Returns the number of ordered pairs of vertex-disjoint faces in
+ * uncoveredPairs that are covered by stored OPD i.
+ */
+int countCoveredPairs(int i, bitset *uncoveredPairs){
+    int j, count = 0;
+    bitset opdOrExtension = UNION(opdFaces[i], extensionFaces[i]);
+    for(j = 0; j < nf; j++){
+        if(CONTAINS(opdFaces[i], j)){
+            count += SIZE(INTERSECTION(uncoveredPairs[j], opdOrExtension));
+        } else if(CONTAINS(extensionFaces[i], j)){
+            count += SIZE(INTERSECTION(uncoveredPairs[j], opdFaces[i]));
+        }
+    }
+    return count;
+}
+
+/* Grows an OPD from each of seedCount start faces, and then keeps a
+ * small set of these OPD's which covers many pairs of vertex-disjoint
+ * faces. The set is chosen with the greedy algorithm for set cover:
+ * repeatedly keep the OPD which covers the most pairs that are not yet
+ * covered. Assumes that computeDisjointFaces() has been called.
+ */
+void constructSetCoverEopds(int seedCount){
+    int i, j;
+    bitset uncoveredPairs[MAXF];
+    
+    if(seedCount > nf){
+        seedCount = nf;
+    }
+    
+    //grow the candidates from start faces spread over all faces
+    for(i = 0; i < seedCount; i++){
+        int face = i * nf / seedCount;
+        greedyExtendOpdAndStore(faceSets[face], SINGLETON(face));
+    }
+    
+    for(i = 0; i < nf; i++){
+        uncoveredPairs[i] = disjointFaces[i];
+    }
+    
+    //greedy set cover: the chosen candidates are moved to the front
+    int candidateCount = eopdCount;
+    int chosenCount = 0;
+    while(chosenCount < candidateCount){
+        int best = -1;
+        int bestCount = 0;
+        for(i = chosenCount; i < candidateCount; i++){
+            int count = countCoveredPairs(i, uncoveredPairs);
+            if(count > bestCount){
+                best = i;
+                bestCount = count;
+            }
+        }
+        if(best == -1){
+            break;
+        }
+        
+        bitset opd = opdFaces[best];
+        bitset extensions = extensionFaces[best];
+        opdFaces[best] = opdFaces[chosenCount];
+        extensionFaces[best] = extensionFaces[chosenCount];
+        opdFaces[chosenCount] = opd;
+        extensionFaces[chosenCount] = extensions;
+        chosenCount++;
+        
+        for(j = 0; j < nf; j++){
+            if(CONTAINS(opd, j)){
+                uncoveredPairs[j] &= ~UNION(opd, extensions);
+            } else if(CONTAINS(extensions, j)){
+                uncoveredPairs[j] &= ~opd;
+            }
+        }
+    }
+    
+    eopdCount = chosenCount;
+}
+
+void constructInitialEopds(){
+    int i;
+    
+    greedyExtendOpdAndStore(faceSets[0], SINGLETON(0));
+    
+    bitset coveredFaces = UNION(opdFaces[lastStoredOpd], extensionFaces[lastStoredOpd]);
+    
+    for(i = nf -1; i > 0; i--){
+        if(!CONTAINS(coveredFaces, i)){
+            greedyExtendOpdAndStore(faceSets[i], SINGLETON(i));
+            ADD_ALL(coveredFaces, opdFaces[lastStoredOpd]);
+            ADD_ALL(coveredFaces, extensionFaces[lastStoredOpd]);
+        }
+    }
+}
+
+/* Searches an uncovered tuple, starting from the OPD's that are
+ * currently stored.
+ */
+boolean findUncoveredFaceTupleWithStoredOpds(){
+    //reset the budget
+    budgetNodeCount = 0;
+    budgetExceeded = FALSE;
+    
+    boolean result = FALSE;
+    switch(tupleSize){
+        case 3:
+            result = findUncoveredFaceTuple_3();
+            break;
+        case 4:
+            result = findUncoveredFaceTuple_4();
+            break;
+        case 5:
+            result = findUncoveredFaceTuple_5();
+            break;
+        case 6:
+            result = findUncoveredFaceTuple_6();
+            break;
+    }
+    
+    if(eopdCount > maximumOpdCount){
+        maximumOpdCount = eopdCount;
+    }
+
+    return result;
+}
+
+boolean findUncoveredFaceTuple(){
+    switchPerfPhase(PERF_PHASE_SEEDING);
+    
+    //reset the stored OPD's and the certificate
+    clearStoredOpds();
+    retiredCertificateCount = 0;
+    
+    //start by constructing some eOPD's to exclude many tuples
+    if(seedCount > 0){
+        computeDisjointFaces();
+        constructSetCoverEopds(seedCount);
+    } else {
+        constructInitialEopds();
+    }
+    
+    switchPerfPhase(PERF_PHASE_LOOKUP);
+    return findUncoveredFaceTupleWithStoredOpds();
+}
+
+//=============== Isomorphism cache ===========================
+
+/* Isomorphic triangulations have the same verdict, so we cache the verdict
+ * for the canonical form of each triangulation. The canonical form is the
+ * lexicographically smallest code obtained by a breadth-first numbering of
+ * the vertices starting from each oriented edge, in both orientations of
+ * the plane. The table has a fixed size: when all slots for a code are in
+ * use, the first one is overwritten.
+ */
+
+#define CANONICAL_CODE_LENGTH (MAXN+MAXE)
+#define ISOMORPHISM_CACHE_PROBES 8
+#define MAX_WITNESS_FACES 8
+
+typedef struct {
+    boolean used;
+    unsigned long long int hash;
+    int length;
+    unsigned char code[CANONICAL_CODE_LENGTH];
+    boolean uncovered;
+    int witnessSize; /* number of faces in the uncovered tuple */
+    unsigned char witness[3*MAX_WITNESS_FACES]; /* canonical labels of their vertices */
+} ISOMORPHISM_CACHE_ENTRY;
+
+ISOMORPHISM_CACHE_ENTRY *isomorphismCache = NULL;
+int isomorphismCacheSize = 0;
+
+unsigned char canonicalCode[CANONICAL_CODE_LENGTH];
+int canonicalCodeLength;
+int canonicalLabel[MAXN]; /* the label of vertex i in the canonical code */
+
+/* Computes the code of the breadth-first numbering starting from the
+ * given edge and compares it to the best code found so far. If it is
+ * smaller, the new code becomes the canonical code. The computation is
+ * aborted as soon as the code is larger than the canonical code.
+ */
+void testCanonicalCode(EDGE *start, boolean mirror){
+    int i, length = 0;
+    int label[MAXN];
+    EDGE *reference[MAXN];
+    int queue[MAXN];
+    int head = 0, tail = 0, nextLabel = 1;
+    boolean smaller = (canonicalCodeLength == 0);
+    
+    for(i = 0; i < nv; i++){
+        label[i] = 0;
+    }
+    label[start->start] = nextLabel++;
+    reference[start->start] = start;
+    queue[tail++] = start->start;
+    
+    while(head < tail){
+        int v = queue[head++];
+        EDGE *e = reference[v];
+        do {
+            if(!label[e->end]){
+                label[e->end] = nextLabel++;
+                reference[e->end] = e->inverse;
+                queue[tail++] = e->end;
+            }
+            if(!smaller){
+                if(label[e->end] > canonicalCode[length]){
+                    return;
+                } else if(label[e->end] < canonicalCode[length]){
+                    smaller = TRUE;
+                }
+            }
+            canonicalCode[length++] = label[e->end];
+            e = mirror ? e->prev : e->next;
+        } while (e != reference[v]);
+        if(!smaller && canonicalCode[length] != 0){
+            //the best code has a longer list here, so the new code is smaller
+            smaller = TRUE;
+        }
+        canonicalCode[length++] = 0;
+    }
+    
+    if(smaller){
+        canonicalCodeLength = length;
+        for(i = 0; i < nv; i++){
+            canonicalLabel[i] = label[i];
+        }
+    }
+}
+
+void computeCanonicalCode(){
+    int i;
+    canonicalCodeLength = 0;
+    for(i = 0; i < ne; i++){
+        testCanonicalCode(edges + i, FALSE);
+        testCanonicalCode(edges + i, TRUE);
+    }
+}
+
+unsigned long long int hashCanonicalCode(){
+    int i;
+    unsigned long long int hash = 14695981039346656037ULL;
+    for(i = 0; i < canonicalCodeLength; i++){
+        hash = (hash ^ canonicalCode[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* Returns the entry for the canonical code, or NULL if the code is not
+ * in the cache.
+ */
+ISOMORPHISM_CACHE_ENTRY *lookupIsomorphismCache(unsigned long long int hash){
+    int i;
+    for(i = 0; i < ISOMORPHISM_CACHE_PROBES; i++){
+        ISOMORPHISM_CACHE_ENTRY *entry = isomorphismCache + (hash + i) % isomorphismCacheSize;
+        if(!entry->used){
+            return NULL;
+        }
+        if(entry->hash == hash && entry->length == canonicalCodeLength &&
+                memcmp(entry->code, canonicalCode, canonicalCodeLength) == 0){
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+void storeInIsomorphismCache(unsigned long long int hash, boolean uncovered){
+    int i, j;
+    ISOMORPHISM_CACHE_ENTRY *entry = isomorphismCache + hash % isomorphismCacheSize;
+    for(i = 0; i < ISOMORPHISM_CACHE_PROBES; i++){
+        if(!isomorphismCache[(hash + i) % isomorphismCacheSize].used){
+            entry = isomorphismCache + (hash + i) % isomorphismCacheSize;
+            break;
+        }
+    }
+    
+    entry->used = TRUE;
+    entry->hash = hash;
+    entry->length = canonicalCodeLength;
+    memcpy(entry->code, canonicalCode, canonicalCodeLength);
+    entry->uncovered = uncovered;
+    entry->witnessSize = 0;
+    if(uncovered){
+        for(i = 0; i < nf; i++){
+            if(CONTAINS(uncoveredTuple, i)){
+                int k = 0;
+                for(j = 0; j < nv; j++){
+                    if(CONTAINS(faceSets[i], j)){
+                        entry->witness[3*entry->witnessSize + k++] = canonicalLabel[j];
+                    }
+                }
+                entry->witnessSize++;
+            }
+        }
+    }
+}
+
+/* Translates the uncovered tuple stored in the entry to the faces of the
+ * current graph.
+ */
+void restoreWitness(ISOMORPHISM_CACHE_ENTRY *entry){
+    int i, j, vertexWithLabel[MAXN + 1];
+    for(i = 0; i < nv; i++){
+        vertexWithLabel[canonicalLabel[i]] = i;
+    }
+    uncoveredTuple = EMPTY_SET;
+    for(i = 0; i < entry->witnessSize; i++){
+        bitset face = SINGLETON(vertexWithLabel[entry->witness[3*i]]) |
+                SINGLETON(vertexWithLabel[entry->witness[3*i + 1]]) |
+                SINGLETON(vertexWithLabel[entry->witness[3*i + 2]]);
+        for(j = 0; j < nf; j++){
+            if(faceSets[j] == face){
+                ADD(uncoveredTuple, j);
+            }
+        }
+    }
+}
+
+/* Looks up the verdict for the current graph in the isomorphism cache,
+ * and only searches for an uncovered tuple if the graph is not found.
+ */
+boolean findUncoveredFaceTupleCached(){
+    switchPerfPhase(PERF_PHASE_LOOKUP);
+    computeCanonicalCode();
+    unsigned long long int hash = hashCanonicalCode();
+    
+    numberOfIsomorphismCacheLookups++;
+    ISOMORPHISM_CACHE_ENTRY *entry = lookupIsomorphismCache(hash);
+    if(entry != NULL){
+        numberOfIsomorphismCacheHits++;
+        budgetExceeded = FALSE;
+        if(entry->uncovered){
+            restoreWitness(entry);
+        }
+        return entry->uncovered;
+    }
+    
+    boolean result = findUncoveredFaceTuple();
+    if(!budgetExceeded){
+        storeInIsomorphismCache(hash, result);
+    }
+    return result;
+}
+
+//=============== Writing planarcode of graph ===========================
+
+/* The planar code of a graph is first encoded in a buffer, so that each
+ * graph is written with a single fwrite.
+ */
+int encodePlanarCodeChar(unsigned char *buffer){
+    int i, length = 0;
+    EDGE *e, *elast;
+    
+    //write the number of vertices
+    buffer[length++] = nv;
+    
+    for(i=0; i<nv; i++){
+        e = elast = firstedge[i];
+        do {
+            buffer[length++] = e->end + 1;
+            e = e->next;
+        } while (e != elast);
+        buffer[length++] = 0;
+    }
+    
+    return length;
+}
+
+int encodePlanarCodeShort(unsigned char *buffer){
+    int i, length = 0;
+    EDGE *e, *elast;
+    unsigned short temp;
+    
+    //write the number of vertices
+    buffer[length++] = 0;
+    temp = nv;
+    memcpy(buffer + length, &temp, sizeof (unsigned short));
+    length += sizeof (unsigned short);
+    
+    for(i=0; i<nv; i++){
+        e = elast = firstedge[i];
+        do {
+            temp = e->end + 1;
+            memcpy(buffer + length, &temp, sizeof (unsigned short));
+            length += sizeof (unsigned short);
+            e = e->next;
+        } while (e != elast);
+        temp = 0;
+        memcpy(buffer + length, &temp, sizeof (unsigned short));
+        length += sizeof (unsigned short);
+    }
+    
+    return length;
+}
+
+void writePlanarCodeToFile(FILE *file){
+    unsigned char buffer[2*MAXCODELENGTH + 1];
+    int length;
+    
+    if (nv + 1 <= 255) {
+        length = encodePlanarCodeChar(buffer);
+    } else if (nv + 1 <= 65535) {
+        length = encodePlanarCodeShort(buffer);
+    } else {
+        fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
+        exit(-1);
+    }
+    
+    if (fwrite(buffer, sizeof (unsigned char), length, file) != (size_t) length) {
+        fprintf(stderr, "fwrite() failed -- exiting!\n");
+        exit(-1);
+    }
+}
+
+void writePlanarCode(){
+    static int first = TRUE;
+    
+    if(first){
+        first = FALSE;
+        
+        fprintf(stdout, ">>planar_code<<");
+    }
+    
+    writePlanarCodeToFile(stdout);
+}
+
+/* Writes the current graph to the file for graphs that exceeded their
+ * budget. The file is only created when the first graph is deferred.
+ */
+FILE *deferredFile = NULL;
+char *deferredFileName = NULL;
+
+void writeDeferredPlanarCode(){
+    if(deferredFile == NULL){
+        deferredFile = fopen(deferredFileName, "wb");
+        if(deferredFile == NULL){
+            fprintf(stderr, "Could not open %s for writing -- exiting!\n", deferredFileName);
+            exit(1);
+        }
+        fprintf(deferredFile, ">>planar_code<<");
+    }
+    
+    writePlanarCodeToFile(deferredFile);
+}
+
+//=============== Writing certificates ===========================
+
+/* The certificate for a covered graph lists the eOPD's that were used
+ * to cover its tuples. Each certificate consists of
+ *   - the index of the graph in the input (starting from 1) as 8 bytes,
+ *   - the number of eOPD's as 4 bytes,
+ *   - for each eOPD the faces of the OPD as a bitset of (nf+7)/8 bytes,
+ *     followed by the extension face as 1 byte, or 255 if the OPD
+ *     itself contains two faces of the tuple.
+ * All numbers are written in little endian order. The faces are numbered
+ * in the order in which makeDual() visits them.
+ */
+void writeLittleEndian(unsigned long long int value, int bytes, FILE *file){
+    int i;
+    for(i = 0; i < bytes; i++){
+        fputc((value >> (8*i)) & 0xFF, file);
+    }
+}
+
+void writeCertificateFaces(bitset faces, FILE *file){
+    int i;
+    if(relabelling != RELABEL_NONE){
+        bitset originalFaces = EMPTY_SET;
+        for(i = 0; i < nf; i++){
+            if(CONTAINS(faces, i)){
+                ADD(originalFaces, originalFace[i]);
+            }
+        }
+        faces = originalFaces;
+    }
+    for(i = 0; i < (nf + 7)/8; i++){
+        fputc((faces >> (8*i)) & 0xFF, file);
+    }
+}
+
+void writeCertificate(unsigned long long int index){
+    int i, j;
+    unsigned int count = 0;
+    
+    for(i = 0; i < eopdCount; i++){
+        count += certificateOpdOnly[i] ? 1 : 0;
+        count += __builtin_popcountll(certificateExtensions[i]);
+    }
+    count += retiredCertificateCount;
+    
+    writeLittleEndian(index, 8, certificateFile);
+    writeLittleEndian(count, 4, certificateFile);
+    for(i = 0; i < retiredCertificateCount; i++){
+        writeCertificateFaces(retiredCertificateOpds[i], certificateFile);
+        j = retiredCertificateExtensions[i];
+        if(j == -1){
+            fputc(255, certificateFile);
+        } else {
+            fputc(relabelling != RELABEL_NONE ? originalFace[j] : j, certificateFile);
+        }
+    }
+    for(i = 0; i < eopdCount; i++){
+        if(certificateOpdOnly[i]){
+            writeCertificateFaces(opdFaces[i], certificateFile);
+            fputc(255, certificateFile);
+        }
+        for(j = 0; j < nf; j++){
+            if(CONTAINS(certificateExtensions[i], j)){
+                writeCertificateFaces(opdFaces[i], certificateFile);
+                fputc(relabelling != RELABEL_NONE ? originalFace[j] : j, certificateFile);
+            }
+        }
+    }
+}
+
+//=============== Writing uncovered graphs ===========================
+
+#define OUTPUT_PLANARCODE 0
+#define OUTPUT_INDEX 1
+#define OUTPUT_WITNESS 2
+#define OUTPUT_BINARY 3
+
+int outputFormat = OUTPUT_PLANARCODE;
+
+/* Writes the index of the current graph in the input (starting from 1)
+ * followed by the faces of the uncovered tuple as vertex triples.
+ */
+void writeWitness(unsigned long long int index){
+    int i, j;
+    fprintf(stdout, "%llu", index);
+    for(i = 0; i < nf; i++){
+        if(CONTAINS(uncoveredTuple, i)){
+            char separator = ' ';
+            for(j = 0; j < nv; j++){
+                if(CONTAINS(faceSets[i], j)){
+                    fprintf(stdout, "%c%d", separator, j+1);
+                    separator = ',';
+                }
+            }
+        }
+    }
+    fprintf(stdout, "\n");
+}
+
+/* Writes the index of the current graph in the input (starting from 1)
+ * as 8 bytes in little endian order followed by the vertices of the
+ * faces of the uncovered tuple as 3 bytes per face.
+ */
+void writeBinaryWitness(unsigned long long int index){
+    int i, j, length = 0;
+    unsigned char buffer[8 + 3*MAXF];
+    for(i = 0; i < 8; i++){
+        buffer[length++] = (index >> (8*i)) & 0xFF;
+    }
+    for(i = 0; i < nf; i++){
+        if(CONTAINS(uncoveredTuple, i)){
+            for(j = 0; j < nv; j++){
+                if(CONTAINS(faceSets[i], j)){
+                    buffer[length++] = j+1;
                 }
             }
         }
-    } else {// size == 4
-        numberOfChecked4Tuples++;
-        //search for eOPD
-        return !findEOPD(tuple);
     }
-    //if we get here then all tuples extending the current tuple were covered
-    return FALSE;
+    if (fwrite(buffer, sizeof (unsigned char), length, stdout) != (size_t) length) {
+        fprintf(stderr, "fwrite() failed -- exiting!\n");
+        exit(-1);
+    }
+}
+
+unsigned long long int numberOfDeferredGraphs = 0;
+
+void writeUncoveredGraph(unsigned long long int index){
+    switch(outputFormat){
+        case OUTPUT_INDEX:
+            fprintf(stdout, "%llu\n", index);
+            break;
+        case OUTPUT_WITNESS:
+            writeWitness(index);
+            break;
+        case OUTPUT_BINARY:
+            writeBinaryWitness(index);
+            break;
+        default:
+            writePlanarCode();
+    }
+}
+
+/* Writes the current graph to the output that corresponds with the
+ * verdict of the search.
+ */
+void writeVerdict(boolean uncovered){
+    switchPerfPhase(PERF_PHASE_OUTPUT);
+    if(uncovered){
+        if(budgetExceeded){
+            writeDeferredPlanarCode();
+            numberOfDeferredGraphs++;
+        } else {
+            writeUncoveredGraph(numberOfGraphs + 1);
+            numberOfUncoveredGraphs++;
+        }
+    } else if(certificateFile != NULL){
+        writeCertificate(numberOfGraphs + 1);
+    }
+}
+
+
+//=============== Counting uncovered tuples ===========================
+
+/* In counting mode all uncovered tuples of each graph are enumerated.
+ * The subtrees of the search for the different first faces are divided
+ * over a number of threads, which are started once and wait for the next
+ * graph when they are done. Each thread has its own stored OPD's, which
+ * it keeps for the next graph, and its own statistics. The uncovered tuples are written in blocks while they are
+ * found, in the order of their first face, so the output does not depend
+ * on the number of threads and the memory for the tuples stays bounded.
+ */
+
+#define MAX_THREADS 256
+
+typedef struct {
+    pthread_t thread;
+    int opdCount;
+} COUNTING_THREAD;
+
+FILE *tupleFile = NULL;
+int threadCount = 0;
+COUNTING_THREAD countingThreads[MAX_THREADS];
+int nextFirstFace;
+
+pthread_mutex_t countingMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t countingStarted = PTHREAD_COND_INITIALIZER;
+pthread_cond_t countingFinished = PTHREAD_COND_INITIALIZER;
+int countingGeneration = 0; //the number of graphs that were given to the threads
+int finishedCountingThreads;
+boolean countingStopped = FALSE;
+
+
+#define TUPLE_BLOCK_SIZE 4096 /* the maximum number of tuples in a block of the output */
+
+bitset *pendingTuples[MAXF]; //the uncovered tuples with face i as first face that are not yet written
+int pendingTupleCount[MAXF];
+boolean firstFaceFinished[MAXF];
+int nextWrittenFace; //the first face whose uncovered tuples are not all written yet
+unsigned long long int graphUncoveredTupleCount; //the uncovered tuples written for the current graph
+pthread_mutex_t tupleFileMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t nextWrittenFaceChanged = PTHREAD_COND_INITIALIZER;
+unsigned char tupleBlockBuffer[TUPLE_BLOCK_SIZE * MAX_TUPLE_SIZE];
+
+unsigned long long int numberOfUncoveredTuples = 0;
+
+/* The file with the uncovered tuples starts with the header
+ * >>eopd_tuples<< followed by the tuple size as 1 byte. For each graph
+ * with uncovered tuples it contains one or more blocks with
+ *   - the index of the graph in the input (starting from 1) as 8 bytes,
+ *   - the number of uncovered tuples in the block as 4 bytes,
+ *   - for each uncovered tuple in the block its faces as 1 byte per face,
+ *     in increasing order.
+ * The blocks of a graph follow each other, and together they contain its
+ * uncovered tuples in the order in which they are enumerated. A block has
+ * at most TUPLE_BLOCK_SIZE tuples. All numbers are written in little
+ * endian order. The faces are numbered in the order in which makeDual()
+ * visits them, as in the certificates.
+ *
+ * Writes the pending tuples with the given first face as a block. This
+ * is called with tupleFileMutex locked.
+ */
+void writeUncoveredTupleBlock(int firstFace){
+    int i, k, length = 0;
+    
+    if(graphUncoveredTupleCount == 0){
+        uncoveredTuple = pendingTuples[firstFace][0];
+    }
+    graphUncoveredTupleCount += pendingTupleCount[firstFace];
+    writeLittleEndian(numberOfGraphs + 1, 8, tupleFile);
+    writeLittleEndian(pendingTupleCount[firstFace], 4, tupleFile);
+    for(i = 0; i < pendingTupleCount[firstFace]; i++){
+        bitset tuple = pendingTuples[firstFace][i];
+        if(relabelling != RELABEL_NONE){
+            bitset originalTuple = EMPTY_SET;
+            for(k = 0; k < nf; k++){
+                if(CONTAINS(tuple, k)){
+                    ADD(originalTuple, originalFace[k]);
+                }
+            }
+            tuple = originalTuple;
+        }
+        while(IS_NOT_EMPTY(tuple)){
+            tupleBlockBuffer[length++] = FIRST_ELEMENT(tuple);
+            tuple &= tuple - 1;
+        }
+    }
+    if (fwrite(tupleBlockBuffer, sizeof (unsigned char), length, tupleFile) != (size_t) length) {
+        fprintf(stderr, "fwrite() failed -- exiting!\n");
+        exit(-1);
+    }
+    pendingTupleCount[firstFace] = 0;
+}
+
+/* Adds an uncovered tuple to the pending tuples of its first face. When
+ * these are a full block, they are written as soon as all tuples with a
+ * smaller first face are written.
+ */
+void storeUncoveredTuple(int firstFace, bitset tuple){
+    if(pendingTupleCount[firstFace] == TUPLE_BLOCK_SIZE){
+        pthread_mutex_lock(&tupleFileMutex);
+        while(nextWrittenFace != firstFace){
+            pthread_cond_wait(&nextWrittenFaceChanged, &tupleFileMutex);
+        }
+        writeUncoveredTupleBlock(firstFace);
+        pthread_mutex_unlock(&tupleFileMutex);
+    }
+    pendingTuples[firstFace][pendingTupleCount[firstFace]++] = tuple;
+}
+
+/* Marks the subtree of the given first face as finished, and writes the
+ * pending tuples of the first faces that can now be written.
+ */
+void finishFirstFace(int firstFace){
+    pthread_mutex_lock(&tupleFileMutex);
+    firstFaceFinished[firstFace] = TRUE;
+    while(nextWrittenFace < nf && firstFaceFinished[nextWrittenFace]){
+        if(pendingTupleCount[nextWrittenFace]){
+            writeUncoveredTupleBlock(nextWrittenFace);
+        }
+        nextWrittenFace++;
+    }
+    pthread_cond_broadcast(&nextWrittenFaceChanged);
+    pthread_mutex_unlock(&tupleFileMutex);
+}
+
+/* Adds the statistics of this thread to the counted statistics, and
+ * starts again from zero.
+ */
+void publishCountingStatistics(){
+    int i;
+    for(i = MIN_TUPLE_SIZE; i <= tupleSize; i++){
+        __sync_fetch_and_add(countedCheckedTuples + i, numberOfCheckedTuples[i]);
+        numberOfCheckedTuples[i] = 0;
+    }
+    __sync_fetch_and_add(&countedTuplesCoveredByStoredOpd, numberOfTuplesCoveredByStoredOpd);
+    __sync_fetch_and_add(&countedEvictedOpds, numberOfEvictedOpds);
+    __sync_fetch_and_add(&countedDominatedOpds, numberOfDominatedOpds);
+    __sync_fetch_and_add(&countedEopdNodes, numberOfEopdNodes);
+    __sync_fetch_and_add(&countedPrunedNodes, numberOfPrunedNodes);
+    numberOfTuplesCoveredByStoredOpd = 0;
+    numberOfEvictedOpds = 0;
+    numberOfDominatedOpds = 0;
+    numberOfEopdNodes = 0;
+    numberOfPrunedNodes = 0;
+}
+
+/* Makes the statistics of this thread visible to the main thread, and
+ * wakes it up to print a progress line.
+ */
+void reportCountingProgress(){
+    publishCountingStatistics();
+    pthread_mutex_lock(&countingMutex);
+    pthread_cond_signal(&countingFinished);
+    pthread_mutex_unlock(&countingMutex);
+}
+
+/* Checks all tuples that consist of the faces in tuple together with
+ * one face of candidates.
+ */
+void countUncoveredLastFaces(bitset tuple, bitset candidates, int firstFace){
+    if(progressRequested){
+        reportCountingProgress();
+    }
+    bitset remaining = candidates & ~storedPartnersOfTuple(tuple);
+    numberOfCheckedTuples[tupleSize] += SIZE(candidates);
+    numberOfTuplesCoveredByStoredOpd += SIZE(candidates) - SIZE(remaining);
+    while(IS_NOT_EMPTY(remaining)){
+        int i = FIRST_ELEMENT(remaining);
+        REMOVE(remaining, i);
+        if(findNewEOPD(UNION(tuple, SINGLETON(i)))){
+            //the new OPD might cover some of the remaining tuples
+            bitset stillRemaining = remaining & ~storedPartnersOfTuple(tuple);
+            numberOfTuplesCoveredByStoredOpd += SIZE(remaining) - SIZE(stillRemaining);
+            remaining = stillRemaining;
+        } else {
+            storeUncoveredTuple(firstFace, UNION(tuple, SINGLETON(i)));
+        }
+    }
+}
+
+/* Counts the uncovered tuples that extend tuple with faces from
+ * candidates. The candidates are the faces with a larger index than the
+ * faces in tuple that share no vertex with them.
+ */
+void countUncoveredFaceTuples_impl(bitset tuple, bitset candidates, int size, int firstFace){
+    if(SIZE(candidates) < tupleSize - size){
+        //there are not enough faces left to complete the tuple
+        return;
+    }
+    if(size >= MIN_TUPLE_SIZE){
+        numberOfCheckedTuples[size]++;
+        if(findEOPD(tuple)){
+            return;
+        }
+    }
+    if(size == tupleSize - 1){
+        countUncoveredLastFaces(tuple, candidates, firstFace);
+        return;
+    }
+    while(IS_NOT_EMPTY(candidates)){
+        int i = FIRST_ELEMENT(candidates);
+        REMOVE(candidates, i);
+        countUncoveredFaceTuples_impl(UNION(tuple, SINGLETON(i)),
+                INTERSECTION(candidates, disjointFaces[i]), size + 1, firstFace);
+    }
+}
+
+/* Adds the counted statistics to those of the main thread. This is only
+ * called while the counting threads wait for the next graph.
+ */
+void mergeCountingStatistics(){
+    int i;
+    for(i = MIN_TUPLE_SIZE; i <= tupleSize; i++){
+        numberOfCheckedTuples[i] += countedCheckedTuples[i];
+        countedCheckedTuples[i] = 0;
+    }
+    numberOfTuplesCoveredByStoredOpd += countedTuplesCoveredByStoredOpd;
+    numberOfEvictedOpds += countedEvictedOpds;
+    numberOfDominatedOpds += countedDominatedOpds;
+    numberOfEopdNodes += countedEopdNodes;
+    numberOfPrunedNodes += countedPrunedNodes;
+    countedTuplesCoveredByStoredOpd = 0;
+    countedEvictedOpds = 0;
+    countedDominatedOpds = 0;
+    countedEopdNodes = 0;
+    countedPrunedNodes = 0;
+}
+
+void *countUncoveredFaceTuplesInThread(void *argument){
+    COUNTING_THREAD *thread = (COUNTING_THREAD *) argument;
+    int i;
+    int generation = 0;
+    
+    while(TRUE){
+        //wait for the next graph
+        pthread_mutex_lock(&countingMutex);
+        while(countingGeneration == generation && !countingStopped){
+            pthread_cond_wait(&countingStarted, &countingMutex);
+        }
+        generation = countingGeneration;
+        boolean stopped = countingStopped;
+        pthread_mutex_unlock(&countingMutex);
+        if(stopped){
+            break;
+        }
+        
+        //each thread starts with its own initial eOPD's
+        clearStoredOpds();
+        if(seedCount > 0){
+            constructSetCoverEopds(seedCount);
+        } else {
+            constructInitialEopds();
+        }
+        
+        while((i = __sync_fetch_and_add(&nextFirstFace, 1)) < nf - tupleSize + 1){
+            countUncoveredFaceTuples_impl(SINGLETON(i), INTERSECTION(disjointFaces[i], ABOVE(i)), 1, i);
+            finishFirstFace(i);
+            publishCountingStatistics();
+        }
+        
+        thread->opdCount = eopdCount;
+        publishCountingStatistics();
+        
+        pthread_mutex_lock(&countingMutex);
+        finishedCountingThreads++;
+        pthread_cond_signal(&countingFinished);
+        pthread_mutex_unlock(&countingMutex);
+    }
+    
+    freeStoredOpds();
+    return NULL;
+}
+
+void startCountingThreads(){
+    int i;
+    for(i = 0; i < threadCount; i++){
+        if(pthread_create(&(countingThreads[i].thread), NULL,
+                countUncoveredFaceTuplesInThread, countingThreads + i)){
+            fprintf(stderr, "Could not create thread -- exiting!\n");
+            exit(1);
+        }
+    }
 }
 
-void constructInitialEopds(){
+void stopCountingThreads(){
+    int i;
+    pthread_mutex_lock(&countingMutex);
+    countingStopped = TRUE;
+    pthread_cond_broadcast(&countingStarted);
+    pthread_mutex_unlock(&countingMutex);
+    for(i = 0; i < threadCount; i++){
+        pthread_join(countingThreads[i].thread, NULL);
+    }
+}
+
+/* Enumerates all uncovered tuples of the current graph and writes them
+ * to the tuple file. Returns the number of uncovered tuples, and stores
+ * the first one in uncoveredTuple.
+ */
+unsigned long long int countUncoveredFaceTuples(){
     int i;
     
-    greedyExtendOpdAndStore(faceSets[0], SINGLETON(0));
+    computeDisjointFaces();
+    for(i = 0; i < nf; i++){
+        if(pendingTuples[i] == NULL){
+            pendingTuples[i] = malloc(TUPLE_BLOCK_SIZE * sizeof(bitset));
+            if(pendingTuples[i] == NULL){
+                fprintf(stderr, "Insufficient memory for the uncovered tuples -- exiting!\n");
+                exit(1);
+            }
+        }
+        pendingTupleCount[i] = 0;
+        //the faces that are never a first face have no tuples to write
+        firstFaceFinished[i] = i > nf - tupleSize;
+    }
+    nextWrittenFace = 0;
+    graphUncoveredTupleCount = 0;
     
-    bitset coveredFaces = UNION(opdFaces[eopdCount-1], extensionFaces[eopdCount-1]);
+    nextFirstFace = 0;
+    pthread_mutex_lock(&countingMutex);
+    finishedCountingThreads = 0;
+    countingGeneration++;
+    pthread_cond_broadcast(&countingStarted);
+    while(finishedCountingThreads < threadCount){
+        if(progressRequested){
+            //a thread woke us up to report the progress in this graph
+            pthread_mutex_unlock(&countingMutex);
+            printProgress();
+            pthread_mutex_lock(&countingMutex);
+        } else {
+            pthread_cond_wait(&countingFinished, &countingMutex);
+        }
+    }
+    pthread_mutex_unlock(&countingMutex);
     
-    for(i = nf -1; i > 0; i--){
-        if(!CONTAINS(coveredFaces, i)){
-            greedyExtendOpdAndStore(faceSets[i], SINGLETON(i));
-            ADD_ALL(coveredFaces, opdFaces[eopdCount-1]);
-            ADD_ALL(coveredFaces, extensionFaces[eopdCount-1]);
+    mergeCountingStatistics();
+    for(i = 0; i < threadCount; i++){
+        if(countingThreads[i].opdCount > maximumOpdCount){
+            maximumOpdCount = countingThreads[i].opdCount;
         }
     }
+    
+    return graphUncoveredTupleCount;
 }
 
-boolean findUncoveredFaceTuple(){
-    //reset counter for eOPD's
-    eopdCount = 0;
+//=============== Input files ===========================
+
+/* The graphs are read from the files given on the command line, or from
+ * standard in. Regular files are mapped in memory, and standard in is
+ * read through a large buffer.
+ */
+
+#define INPUT_BUFFER_SIZE (1 << 20)
+
+typedef struct {
+    char *name;
+    FILE *file; //NULL if the input is mapped in memory
+    unsigned char *data;
+    size_t size;
+    size_t position;
+    boolean headerRead;
+} INPUT;
+
+boolean openInput(INPUT *input, char *name){
+    struct stat status;
+    input->name = name;
+    input->file = NULL;
+    input->data = NULL;
+    input->size = input->position = 0;
+    input->headerRead = FALSE;
     
-    //start by constructing some eOPD's to exclude many tuples
-    constructInitialEopds();
+    if(strcmp(name, "-") == 0){
+        input->file = stdin;
+        setvbuf(stdin, NULL, _IOFBF, INPUT_BUFFER_SIZE);
+        return TRUE;
+    }
     
-    boolean result = FALSE;
-    int i;
-    for(i = 0; i < nf - 3; i++){
-        result = findUncoveredFaceTuple_impl(SINGLETON(i), faceSets[i], i + 1, 1);
-        if(result){
-            break;
+    int fd = open(name, O_RDONLY);
+    if(fd < 0){
+        return FALSE;
+    }
+    if(fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0){
+        void *data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data != MAP_FAILED){
+            madvise(data, status.st_size, MADV_SEQUENTIAL);
+            madvise(data, status.st_size, MADV_WILLNEED);
+            close(fd);
+            input->data = data;
+            input->size = status.st_size;
+            return TRUE;
         }
     }
     
-    if(eopdCount > maximumOpdCount){
-        maximumOpdCount = eopdCount;
+    //fall back to buffered reading, e.g., for pipes
+    input->file = fdopen(fd, "rb");
+    if(input->file == NULL){
+        close(fd);
+        return FALSE;
     }
+    setvbuf(input->file, NULL, _IOFBF, INPUT_BUFFER_SIZE);
+    return TRUE;
+}
 
-    return result;
+void closeInput(INPUT *input){
+    if(input->data != NULL){
+        munmap(input->data, input->size);
+    } else if(input->file != stdin){
+        fclose(input->file);
+    }
 }
 
-//=============== Writing planarcode of graph ===========================
+static inline int getInput(INPUT *input){
+    if(input->file != NULL){
+        return getc(input->file);
+    }
+    return input->position < input->size ? input->data[input->position++] : EOF;
+}
 
-void writePlanarCodeChar(){
-    int i;
-    EDGE *e, *elast;
-    
-    //write the number of vertices
-    fputc(nv, stdout);
-    
-    for(i=0; i<nv; i++){
-        e = elast = firstedge[i];
-        do {
-            fputc(e->end + 1, stdout);
-            e = e->next;
-        } while (e != elast);
-        fputc(0, stdout);
+/* Reads count elements of the given size, like fread().
+ */
+static inline size_t readInput(void *buffer, size_t size, size_t count, INPUT *input){
+    if(input->file != NULL){
+        return fread(buffer, size, count, input->file);
     }
+    size_t available = (input->size - input->position) / size;
+    if(count > available){
+        count = available;
+    }
+    memcpy(buffer, input->data + input->position, count * size);
+    input->position += count * size;
+    return count;
 }
 
-void writePlanarCodeShort(){
-    int i;
-    EDGE *e, *elast;
-    unsigned short temp;
+//=============== Reading and decoding planarcode ===========================
+
+EDGE *edgeMatrix[MAXN][MAXN];
+
+/* Computes the distance between each pair of faces in the dual graph.
+ * The breadth-first searches from all faces are done at the same time:
+ * after d steps, reached[i] contains the faces at distance at most d
+ * from face i.
+ */
+void computeDualDistances(){
+    int i, j, distance;
+    bitset dualNeighbours[MAXF][3];
+    bitset reached[MAXF], nextReached[MAXF];
     
-    //write the number of vertices
-    fputc(0, stdout);
-    temp = nv;
-    if (fwrite(&temp, sizeof (unsigned short), 1, stdout) != 1) {
-        fprintf(stderr, "fwrite() failed -- exiting!\n");
-        exit(-1);
+    for(i = 0; i < nf; i++){
+        EDGE *e = facestart[i];
+        for(j = 0; j < 3; j++){
+            dualNeighbours[i][j] = e->inverse->rightface;
+            e = e->inverse->prev;
+        }
+        reached[i] = SINGLETON(i);
+        dualDistance[i][i] = 0;
     }
     
-    for(i=0; i<nf; i++){
-        e = elast = firstedge[i];
-        do {
-            temp = e->end + 1;
-            if (fwrite(&temp, sizeof (unsigned short), 1, stdout) != 1) {
-                fprintf(stderr, "fwrite() failed -- exiting!\n");
-                exit(-1);
+    boolean changed = TRUE;
+    for(distance = 1; changed; distance++){
+        changed = FALSE;
+        for(i = 0; i < nf; i++){
+            nextReached[i] = reached[i] | reached[dualNeighbours[i][0]] |
+                    reached[dualNeighbours[i][1]] | reached[dualNeighbours[i][2]];
+            bitset newFaces = nextReached[i] & ~reached[i];
+            if(IS_NOT_EMPTY(newFaces)){
+                changed = TRUE;
+                while(IS_NOT_EMPTY(newFaces)){
+                    j = FIRST_ELEMENT(newFaces);
+                    REMOVE(newFaces, j);
+                    dualDistance[i][j] = distance;
+                }
             }
-            e = e->next;
-        } while (e != elast);
-        temp = 0;
-        if (fwrite(&temp, sizeof (unsigned short), 1, stdout) != 1) {
-            fprintf(stderr, "fwrite() failed -- exiting!\n");
-            exit(-1);
         }
+        memcpy(reached, nextReached, nf * sizeof(bitset));
     }
 }
 
-void writePlanarCode(){
-    static int first = TRUE;
-    
-    if(first){
-        first = FALSE;
-        
-        fprintf(stdout, ">>planar_code<<");
+void computeVertexFaces(){
+    int i, v;
+    for(v = 0; v < nv; v++){
+        vertexFaces[v] = EMPTY_SET;
     }
-    
-    if (nv + 1 <= 255) {
-        writePlanarCodeChar();
-    } else if (nv + 1 <= 65535) {
-        writePlanarCodeShort();
-    } else {
-        fprintf(stderr, "Graphs of that size are currently not supported -- exiting!\n");
-        exit(-1);
+    for(i = 0; i < nf; i++){
+        bitset vertices = faceSets[i];
+        while(IS_NOT_EMPTY(vertices)){
+            v = FIRST_ELEMENT(vertices);
+            REMOVE(vertices, v);
+            ADD(vertexFaces[v], i);
+        }
     }
-    
 }
 
-
-//=============== Reading and decoding planarcode ===========================
-
-EDGE *edgeMatrix[MAXN][MAXN];
-
 /* Store in the rightface field of each edge the number of the face on
    the right hand side of that edge.  Faces are numbered 0,1,....  Also
    store in facestart[i] an example of an edge in the clockwise orientation
@@ -473,6 +2339,11 @@ void makeDual() {
             e = e->next;
         } while (e != ex);
     }
+    
+    computeVertexFaces();
+    if(goalDirected){
+        computeDualDistances();
+    }
 }
 
 void decodePlanarCode(unsigned short* code) {
@@ -538,15 +2409,111 @@ void decodePlanarCode(unsigned short* code) {
     // nv - ne/2 + nf = 2
 }
 
+//=============== Relabelling faces ===========================
+
+/* Gives face order[i] the label i. The numbering of the faces determines
+ * the order in which the tuples are enumerated and the bits used for
+ * each face in the bitsets.
+ */
+void relabelFaces(int *order){
+    int i;
+    int newLabel[MAXF];
+    EDGE *oldFacestart[MAXF];
+    int oldFaceSize[MAXF];
+    bitset oldFaceSets[MAXF];
+    
+    memcpy(oldFacestart, facestart, nf * sizeof(EDGE *));
+    memcpy(oldFaceSize, faceSize, nf * sizeof(int));
+    memcpy(oldFaceSets, faceSets, nf * sizeof(bitset));
+    
+    for(i = 0; i < nf; i++){
+        newLabel[order[i]] = i;
+        originalFace[i] = order[i];
+        facestart[i] = oldFacestart[order[i]];
+        faceSize[i] = oldFaceSize[order[i]];
+        faceSets[i] = oldFaceSets[order[i]];
+    }
+    for(i = 0; i < ne; i++){
+        edges[i].rightface = newLabel[edges[i].rightface];
+    }
+    computeVertexFaces();
+    if(goalDirected){
+        computeDualDistances();
+    }
+}
+
+/* Orders the faces in breadth-first order in the dual starting from
+ * face 0, so that neighbouring faces get nearby labels.
+ */
+void breadthFirstFaceOrder(int *order){
+    int i, head = 0, tail = 0;
+    bitset visited = SINGLETON(0);
+    order[tail++] = 0;
+    while(head < tail){
+        EDGE *e = facestart[order[head++]];
+        for(i = 0; i < 3; i++){
+            int neighbour = e->inverse->rightface;
+            if(!CONTAINS(visited, neighbour)){
+                ADD(visited, neighbour);
+                order[tail++] = neighbour;
+            }
+            e = e->inverse->prev;
+        }
+    }
+}
+
+/* Orders the faces by increasing key. Faces with the same key keep
+ * their relative order.
+ */
+void sortFaceOrder(int *order, int *key){
+    int i, j;
+    for(i = 0; i < nf; i++){
+        int face = order[i];
+        for(j = i; j > 0 && key[order[j-1]] > key[face]; j--){
+            order[j] = order[j-1];
+        }
+        order[j] = face;
+    }
+}
+
+void relabelFacesForSearch(){
+    int i;
+    int order[MAXF];
+    int key[MAXF];
+    
+    for(i = 0; i < nf; i++){
+        order[i] = i;
+    }
+    
+    if(relabelling == RELABEL_BFS){
+        breadthFirstFaceOrder(order);
+    } else if(relabelling == RELABEL_DEGREE){
+        //faces with low degree vertices first
+        for(i = 0; i < nf; i++){
+            EDGE *e = facestart[i];
+            key[i] = degree[e->start] + degree[e->end] + degree[e->next->end];
+        }
+        sortFaceOrder(order, key);
+    } else if(relabelling == RELABEL_PARTNERS){
+        //faces in many vertex-disjoint pairs first
+        computeDisjointFaces();
+        for(i = 0; i < nf; i++){
+            key[i] = -SIZE(disjointFaces[i]);
+        }
+        sortFaceOrder(order, key);
+    }
+    
+    relabelFaces(order);
+}
+
 /**
  * 
  * @param code
  * @param length
- * @param file
+ * @param input
  * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
  */
-int readPlanarCode(unsigned short code[], int *length, FILE *file) {
-    static int first = 1;
+int readPlanarCode(unsigned short code[], int *length, INPUT *input) {
     unsigned char c;
     char testheader[20];
     int bufferSize, zeroCounter;
@@ -554,10 +2521,10 @@ int readPlanarCode(unsigned short code[], int *length, FILE *file) {
     int readCount;
 
 
-    if (first) {
-        first = 0;
+    if (!input->headerRead) {
+        input->headerRead = TRUE;
 
-        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
+        if (readInput(&testheader, sizeof (unsigned char), 13, input) != 13) {
             fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
             exit(1);
         }
@@ -569,22 +2536,22 @@ int readPlanarCode(unsigned short code[], int *length, FILE *file) {
             exit(1);
         }
         //read reminder of header (either empty or le/be specification)
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
+        if (readInput(&c, sizeof (unsigned char), 1, input) == 0) {
             return FALSE;
         }
         while (c!='<'){
-            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
+            if (readInput(&c, sizeof (unsigned char), 1, input) == 0) {
                 return FALSE;
             }
         }
         //read one more character
-        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
+        if (readInput(&c, sizeof (unsigned char), 1, input) == 0) {
             return FALSE;
         }
     }
 
     /* possibly removing interior headers -- only done for planarcode */
-    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
+    if (readInput(&c, sizeof (unsigned char), 1, input) == 0) {
         //nothing left in file
         return (0);
     }
@@ -594,21 +2561,21 @@ int readPlanarCode(unsigned short code[], int *length, FILE *file) {
         code[0] = c;
         bufferSize = 1;
         zeroCounter = 0;
-        code[1] = (unsigned short) getc(file);
+        code[1] = (unsigned short) getInput(input);
         if (code[1] == 0) zeroCounter++;
-        code[2] = (unsigned short) getc(file);
+        code[2] = (unsigned short) getInput(input);
         if (code[2] == 0) zeroCounter++;
         bufferSize = 3;
         // 3 characters were read and stored in buffer
         if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
-            while ((c = getc(file)) != '<');
+            while ((c = getInput(input)) != '<');
             /* read 2 more characters: */
-            c = getc(file);
+            c = getInput(input);
             if (c != '<') {
                 fprintf(stderr, "Problems with header -- single '<'\n");
                 exit(1);
             }
-            if (!fread(&c, sizeof (unsigned char), 1, file)) {
+            if (!readInput(&c, sizeof (unsigned char), 1, input)) {
                 //nothing left in file
                 return (0);
             }
@@ -628,12 +2595,12 @@ int readPlanarCode(unsigned short code[], int *length, FILE *file) {
             exit(1);
         }
         while (zeroCounter < code[0]) {
-            code[bufferSize] = (unsigned short) getc(file);
+            code[bufferSize] = (unsigned short) getInput(input);
             if (code[bufferSize] == 0) zeroCounter++;
             bufferSize++;
         }
     } else {
-        readCount = fread(code, sizeof (unsigned short), 1, file);
+        readCount = readInput(code, sizeof (unsigned short), 1, input);
         if(!readCount){
             fprintf(stderr, "Unexpected EOF.\n");
             exit(1);
@@ -645,7 +2612,7 @@ int readPlanarCode(unsigned short code[], int *length, FILE *file) {
         bufferSize = 1;
         zeroCounter = 0;
         while (zeroCounter < code[0]) {
-            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
+            readCount = readInput(code + bufferSize, sizeof (unsigned short), 1, input);
             if(!readCount){
                 fprintf(stderr, "Unexpected EOF.\n");
                 exit(1);
@@ -659,20 +2626,350 @@ int readPlanarCode(unsigned short code[], int *length, FILE *file) {
     return (1);
 }
 
+//=============== Edge flips ===========================
+
+/* In flip mode the first graph is the base graph, and each line of the
+ * flip file contains two vertices u v (starting from 1) of an edge that
+ * is flipped in the current graph. The resulting triangulations are
+ * checked one after the other. A flip only changes two faces, so the
+ * graph is updated in place and the stored OPD's that are not affected
+ * by the flip are kept. The kept OPD's are in no useful order, so in this
+ * mode an OPD that covers a tuple is moved to the front.
+ */
+
+FILE *flipFile = NULL;
+unsigned long long int numberOfFlips = 0;
+unsigned long long int numberOfSkippedFlips = 0;
+unsigned long long int numberOfInvalidatedOpds = 0;
+
+EDGE *findEdge(int u, int v){
+    EDGE *e, *elast;
+    e = elast = firstedge[u];
+    do {
+        if(e->end == v){
+            return e;
+        }
+        e = e->next;
+    } while (e != elast);
+    return NULL;
+}
+
+/* Stores face as the face to the right of e, and updates the faces of
+ * the edges of this face.
+ */
+void setTriangularFace(int face, EDGE *e){
+    int i;
+    facestart[face] = e;
+    faceSize[face] = 3;
+    faceSets[face] = EMPTY_SET;
+    for(i = 0; i < 3; i++){
+        e->rightface = face;
+        ADD(faceSets[face], e->end);
+        e = e->inverse->prev;
+    }
+}
+
+/* Replaces the edge uv by the edge ab, where uva and vub are the two
+ * faces containing uv. The two oriented edges of uv are reused for ab and
+ * the two faces keep their numbers. Returns the edge from a to b, or NULL
+ * if u and v are not adjacent, or if the flip would create a multiple
+ * edge or a vertex with degree 2. In that case the graph is unchanged.
+ */
+EDGE *flipEdge(int u, int v){
+    if(u < 0 || u >= nv || v < 0 || v >= nv || !CONTAINS(neighbourhood[u], v)){
+        return NULL;
+    }
+    EDGE *e = findEdge(u, v);
+    EDGE *f = e->inverse;
+    int a = e->next->end;
+    int b = e->prev->end;
+    if(degree[u] <= 3 || degree[v] <= 3 || CONTAINS(neighbourhood[a], b)){
+        return NULL;
+    }
+    int face1 = e->rightface;
+    int face2 = f->rightface;
+    
+    EDGE *au = e->next->inverse;
+    EDGE *bv = f->next->inverse;
+
+    //remove uv
+    e->prev->next = e->next;
+    e->next->prev = e->prev;
+    if(firstedge[u] == e){
+        firstedge[u] = e->next;
+    }
+    f->prev->next = f->next;
+    f->next->prev = f->prev;
+    if(firstedge[v] == f){
+        firstedge[v] = f->next;
+    }
+    degree[u]--;
+    degree[v]--;
+    REMOVE(neighbourhood[u], v);
+    REMOVE(neighbourhood[v], u);
+
+    //insert ab between au and av
+    e->start = a;
+    e->end = b;
+    e->prev = au;
+    e->next = au->next;
+    au->next->prev = e;
+    au->next = e;
+
+    //insert ba between bv and bu
+    f->start = b;
+    f->end = a;
+    f->prev = bv;
+    f->next = bv->next;
+    bv->next->prev = f;
+    bv->next = f;
+
+    degree[a]++;
+    degree[b]++;
+    ADD(neighbourhood[a], b);
+    ADD(neighbourhood[b], a);
+    e->vertices = f->vertices = UNION(SINGLETON(a), SINGLETON(b));
+    
+    //the faces abv and bau replace the faces uva and vub
+    setTriangularFace(face1, e);
+    setTriangularFace(face2, f);
+    computeVertexFaces();
+    if(goalDirected){
+        computeDualDistances();
+    }
+    
+    return e;
+}
+
+/* Removes the stored OPD's that are no longer valid after the flip that
+ * created the edge flipped, and updates the extensions of the other
+ * OPD's. An OPD is no longer valid if it contains one of the two faces
+ * that were changed by the flip, or if the new edge is a chord of it.
+ */
+void invalidateStoredOpds(EDGE *flipped){
+    int i, j;
+    int count = 0;
+    int face1 = flipped->rightface;
+    int face2 = flipped->inverse->rightface;
+    bitset changedFaces = UNION(SINGLETON(face1), SINGLETON(face2));
+    for(i = 0; i < eopdCount; i++){
+        if(IS_NOT_EMPTY(INTERSECTION(opdFaces[i], changedFaces))){
+            continue;
+        }
+        bitset vertices = EMPTY_SET;
+        for(j = 0; j < nf; j++){
+            if(CONTAINS(opdFaces[i], j)){
+                ADD_ALL(vertices, faceSets[j]);
+            }
+        }
+        if(CONTAINS_ALL(vertices, flipped->vertices)){
+            continue;
+        }
+        opdFaces[count] = opdFaces[i];
+        extensionFaces[count] = extensionFaces[i] & ~changedFaces;
+        if(HAS_MORE_THAN_ONE_ELEMENT(INTERSECTION(faceSets[face1], vertices))){
+            ADD(extensionFaces[count], face1);
+        }
+        if(HAS_MORE_THAN_ONE_ELEMENT(INTERSECTION(faceSets[face2], vertices))){
+            ADD(extensionFaces[count], face2);
+        }
+        count++;
+    }
+    numberOfInvalidatedOpds += eopdCount - count;
+    eopdCount = count;
+    
+    //the pairs of the removed OPD's are no longer covered
+    for(i = 0; i < nf; i++){
+        storedPartners[i] = EMPTY_SET;
+    }
+    for(i = 0; i < eopdCount; i++){
+        addStoredPartners(i);
+    }
+}
+
+/* Reads the next flip from the flip file. Empty lines and lines starting
+ * with # are skipped. Returns FALSE at the end of the file.
+ */
+boolean readFlip(int *u, int *v){
+    char line[256];
+    while(fgets(line, sizeof(line), flipFile) != NULL){
+        if(line[0] == '#' || line[0] == '\n'){
+            continue;
+        }
+        if(sscanf(line, "%d %d", u, v) != 2){
+            fprintf(stderr, "Could not read flip: %s", line);
+            continue;
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* Applies the flips to the current graph, and checks each of the
+ * resulting triangulations.
+ */
+void checkFlips(){
+    int u, v;
+    while(readFlip(&u, &v)){
+        switchPerfPhase(PERF_PHASE_DECODE);
+        EDGE *flipped = flipEdge(u - 1, v - 1);
+        if(flipped == NULL){
+            fprintf(stderr, "Could not flip edge %d %d -- skipping.\n", u, v);
+            numberOfSkippedFlips++;
+            continue;
+        }
+        numberOfFlips++;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &graphStart);
+        switchPerfPhase(PERF_PHASE_SEEDING);
+        invalidateStoredOpds(flipped);
+        switchPerfPhase(PERF_PHASE_LOOKUP);
+        writeVerdict(findUncoveredFaceTupleWithStoredOpds());
+        finishGraphPerf(numberOfGraphs + 1);
+        numberOfGraphs++;
+        if(progressRequested){
+            printProgress();
+        }
+    }
+}
+
+/* Checks all graphs in the input. Returns FALSE if the remaining inputs
+ * should not be read.
+ */
+boolean checkInput(INPUT *input){
+    unsigned short code[MAXCODELENGTH];
+    int length;
+    switchPerfPhase(PERF_PHASE_DECODE);
+    while (readPlanarCode(code, &length, input)) {
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &graphStart);
+        decodePlanarCode(code);
+        if(relabelling != RELABEL_NONE){
+            relabelFacesForSearch();
+        }
+        if(tupleFile != NULL){
+            unsigned long long int count = countUncoveredFaceTuples();
+            if(count){
+                writeUncoveredGraph(numberOfGraphs + 1);
+                numberOfUncoveredGraphs++;
+                numberOfUncoveredTuples += count;
+            }
+        } else {
+            writeVerdict(isomorphismCacheSize ?
+                    findUncoveredFaceTupleCached() : findUncoveredFaceTuple());
+        }
+        finishGraphPerf(numberOfGraphs + 1);
+        numberOfGraphs++;
+        if(progressRequested){
+            printProgress();
+        }
+        if(flipFile != NULL){
+            //the other graphs are obtained by flipping edges in the first one
+            checkFlips();
+            return FALSE;
+        }
+        switchPerfPhase(PERF_PHASE_DECODE);
+    }
+    switchPerfPhase(PERF_PHASE_NONE);
+    return TRUE;
+}
+
 //====================== USAGE =======================
 
 void help(char *name) {
     fprintf(stderr, "The program %s checks extended outer planar discs in plane triangulations.\n\n", name);
     fprintf(stderr, "Usage\n=====\n");
-    fprintf(stderr, " %s [options]\n\n", name);
+    fprintf(stderr, " %s [options] [file ...]\n\n", name);
+    fprintf(stderr, "Reads the graphs in planar_code from the given files one after the other,\n");
+    fprintf(stderr, "or from standard in if no files are given (or for the file -). Regular\n");
+    fprintf(stderr, "files are mapped in memory. Statistics are also reported per file.\n");
     fprintf(stderr, "\nThis program can handle graphs up to %d vertices.\n\n", MAXN);
     fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -a, --all file\n");
+    fprintf(stderr, "       Enumerate all uncovered tuples of each graph instead of stopping at\n");
+    fprintf(stderr, "       the first one, and write them in a compact binary format to the\n");
+    fprintf(stderr, "       given file. This cannot be combined with a budget, certificates or\n");
+    fprintf(stderr, "       the isomorphism cache.\n");
+    fprintf(stderr, "    -b, --budget s\n");
+    fprintf(stderr, "       Give up on a graph after s seconds and write it unchanged to the\n");
+    fprintf(stderr, "       file given by --deferred, so it can be handled in a later pass.\n");
+    fprintf(stderr, "    -j, --threads n\n");
+    fprintf(stderr, "       Use n threads to enumerate the uncovered tuples with --all\n");
+    fprintf(stderr, "       (default: the number of processors).\n");
+    fprintf(stderr, "    -k, --tuple-size k\n");
+    fprintf(stderr, "       Check the k-tuples of vertex-disjoint faces (default: 4). Valid\n");
+    fprintf(stderr, "       values are %d to %d.\n", MIN_TUPLE_SIZE, MAX_TUPLE_SIZE);
+    fprintf(stderr, "    -m, --max-opds n\n");
+    fprintf(stderr, "       Store at most n OPD's per graph. When this limit is reached, a\n");
+    fprintf(stderr, "       stored OPD is evicted according to the eviction policy.\n");
+    fprintf(stderr, "    -e, --eviction policy\n");
+    fprintf(stderr, "       The eviction policy for --max-opds. Valid policies are:\n");
+    fprintf(stderr, "         lru: evict the OPD that has not covered a tuple for the\n");
+    fprintf(stderr, "              longest time, approximately (default)\n");
+    fprintf(stderr, "         fifo: evict the OPD that was stored first\n");
+    fprintf(stderr, "    -n, --node-budget n\n");
+    fprintf(stderr, "       Give up on a graph after n nodes in the eOPD search and write it\n");
+    fprintf(stderr, "       unchanged to the file given by --deferred.\n");
+    fprintf(stderr, "    -g, --goal-directed\n");
+    fprintf(stderr, "       Compute the distances between the faces in the dual, and grow each\n");
+    fprintf(stderr, "       eOPD towards the nearest face of the tuple first. This needs fewer\n");
+    fprintf(stderr, "       nodes for the eOPD's that are found, but not for the tuples for\n");
+    fprintf(stderr, "       which no eOPD exists.\n");
+    fprintf(stderr, "    -l, --lookahead\n");
+    fprintf(stderr, "       Stop growing an eOPD as soon as none of the remaining faces of the\n");
+    fprintf(stderr, "       tuple can still be reached through vertices that can be added.\n");
+    fprintf(stderr, "    -c, --certificate file\n");
+    fprintf(stderr, "       Write a certificate for each covered graph to the given file. The\n");
+    fprintf(stderr, "       certificates can be checked with verify_certificates.\n");
+    fprintf(stderr, "    -d, --deferred file\n");
+    fprintf(stderr, "       The file to which the graphs that exceeded their budget are written.\n");
+    fprintf(stderr, "    -f, --flips file\n");
+    fprintf(stderr, "       Only read the first graph, and then apply the edge flips in the\n");
+    fprintf(stderr, "       given file one after the other. Each line contains the vertices\n");
+    fprintf(stderr, "       u v of an edge. The graph is checked after each flip, reusing the\n");
+    fprintf(stderr, "       stored OPD's that are not affected by the flip. This cannot be\n");
+    fprintf(stderr, "       combined with --all, certificates, relabelling or the isomorphism\n");
+    fprintf(stderr, "       cache.\n");
+    fprintf(stderr, "    -i, --isomorphism-cache n\n");
+    fprintf(stderr, "       Remember the verdict for up to n triangulations, and reuse it for\n");
+    fprintf(stderr, "       triangulations that are isomorphic to one of them. This cannot be\n");
+    fprintf(stderr, "       combined with certificates.\n");
+    fprintf(stderr, "    -o, --output format\n");
+    fprintf(stderr, "       The output for each uncovered graph. Valid formats are:\n");
+    fprintf(stderr, "         planarcode: the graph in planar_code (default)\n");
+    fprintf(stderr, "         index: the index of the graph in the input (starting from 1)\n");
+    fprintf(stderr, "         witness: the index followed by the uncovered tuple of faces,\n");
+    fprintf(stderr, "                  each face given as its vertices u,v,w\n");
+    fprintf(stderr, "         binary: the index as 8 bytes in little endian order, followed\n");
+    fprintf(stderr, "                 by the vertices of the faces of the uncovered tuple,\n");
+    fprintf(stderr, "                 3 bytes per face\n");
+    fprintf(stderr, "    -p, --progress n\n");
+    fprintf(stderr, "       Print a progress line every n seconds. A progress line is also\n");
+    fprintf(stderr, "       printed whenever the program receives SIGUSR1.\n");
+    fprintf(stderr, "    -r, --relabel order\n");
+    fprintf(stderr, "       Relabel the faces before the search. This changes the order in\n");
+    fprintf(stderr, "       which the tuples are checked. Valid orders are:\n");
+    fprintf(stderr, "         none: the order in which the faces are found (default)\n");
+    fprintf(stderr, "         bfs: breadth-first order in the dual\n");
+    fprintf(stderr, "         degree: by increasing sum of the degrees of the vertices\n");
+    fprintf(stderr, "         partners: by decreasing number of vertex-disjoint faces\n");
+    fprintf(stderr, "    -s, --seeds n\n");
+    fprintf(stderr, "       Grow initial OPD's from n start faces and keep a small set of them\n");
+    fprintf(stderr, "       that covers many pairs of vertex-disjoint faces. By default the\n");
+    fprintf(stderr, "       initial OPD's are grown from faces that are not yet covered.\n");
+    fprintf(stderr, "    --perf[=graph]\n");
+    fprintf(stderr, "       Count cycles, instructions, branch misses, L1 data cache misses and\n");
+    fprintf(stderr, "       last level cache misses with the hardware performance counters,\n");
+    fprintf(stderr, "       and report them separately for decoding, seeding the initial OPD's,\n");
+    fprintf(stderr, "       looking up the stored OPD's, searching new eOPD's and writing the\n");
+    fprintf(stderr, "       output. With --perf=graph the counts are also reported per graph.\n");
+    fprintf(stderr, "       This cannot be combined with --all.\n");
+    fprintf(stderr, "    -t, --time\n");
+    fprintf(stderr, "       Report the time spent reading and checking the graphs.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
 
 void usage(char *name) {
-    fprintf(stderr, "Usage: %s [options]\n", name);
+    fprintf(stderr, "Usage: %s [options] [file ...]\n", name);
     fprintf(stderr, "For more information type: %s -h \n\n", name);
 }
 
@@ -680,15 +2977,154 @@ int main(int argc, char *argv[]) {
 
     /*=========== commandline parsing ===========*/
 
-    int c;
+    int c, i;
     char *name = argv[0];
     static struct option long_options[] = {
-         {"help", no_argument, NULL, 'h'}
+         {"all", required_argument, NULL, 'a'},
+         {"budget", required_argument, NULL, 'b'},
+         {"threads", required_argument, NULL, 'j'},
+         {"tuple-size", required_argument, NULL, 'k'},
+         {"max-opds", required_argument, NULL, 'm'},
+         {"eviction", required_argument, NULL, 'e'},
+         {"node-budget", required_argument, NULL, 'n'},
+         {"goal-directed", no_argument, NULL, 'g'},
+         {"lookahead", no_argument, NULL, 'l'},
+         {"certificate", required_argument, NULL, 'c'},
+         {"deferred", required_argument, NULL, 'd'},
+         {"flips", required_argument, NULL, 'f'},
+         {"isomorphism-cache", required_argument, NULL, 'i'},
+         {"output", required_argument, NULL, 'o'},
+         {"progress", required_argument, NULL, 'p'},
+         {"relabel", required_argument, NULL, 'r'},
+         {"seeds", required_argument, NULL, 's'},
+         {"time", no_argument, NULL, 't'},
+         {"perf", optional_argument, NULL, 'P'},
+         {"help", no_argument, NULL, 'h'},
+         {NULL, 0, NULL, 0}
     };
     int option_index = 0;
+    
+    boolean reportTime = FALSE;
+    int progressInterval = 0;
 
-    while ((c = getopt_long(argc, argv, "h", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "a:b:e:j:k:m:n:glc:d:f:i:o:p:r:s:th", long_options, &option_index)) != -1) {
         switch (c) {
+            case 'a':
+                tupleFile = fopen(optarg, "wb");
+                if(tupleFile == NULL){
+                    fprintf(stderr, "Could not open %s for writing -- exiting!\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'b':
+                timeBudget = atof(optarg);
+                break;
+            case 'j':
+                threadCount = atoi(optarg);
+                break;
+            case 'k':
+                tupleSize = atoi(optarg);
+                if(tupleSize < MIN_TUPLE_SIZE || tupleSize > MAX_TUPLE_SIZE){
+                    fprintf(stderr, "The tuple size should be between %d and %d.\n",
+                            MIN_TUPLE_SIZE, MAX_TUPLE_SIZE);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'm':
+                maximumStoredOpds = atoi(optarg);
+                break;
+            case 'e':
+                if(strcmp(optarg, "lru") == 0){
+                    evictionPolicy = EVICT_LRU;
+                } else if(strcmp(optarg, "fifo") == 0){
+                    evictionPolicy = EVICT_FIFO;
+                } else {
+                    fprintf(stderr, "Unknown eviction policy %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'n':
+                nodeBudget = strtoull(optarg, NULL, 10);
+                break;
+            case 'g':
+                goalDirected = TRUE;
+                break;
+            case 'l':
+                lookahead = TRUE;
+                break;
+            case 'c':
+                certificateFile = fopen(optarg, "wb");
+                if(certificateFile == NULL){
+                    fprintf(stderr, "Could not open %s for writing -- exiting!\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                fprintf(certificateFile, ">>eopd_certificate<<");
+                break;
+            case 'd':
+                deferredFileName = optarg;
+                break;
+            case 'f':
+                flipFile = fopen(optarg, "r");
+                if(flipFile == NULL){
+                    fprintf(stderr, "Could not open %s -- exiting!\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'i':
+                isomorphismCacheSize = atoi(optarg);
+                break;
+            case 'o':
+                if(strcmp(optarg, "planarcode") == 0){
+                    outputFormat = OUTPUT_PLANARCODE;
+                } else if(strcmp(optarg, "index") == 0){
+                    outputFormat = OUTPUT_INDEX;
+                } else if(strcmp(optarg, "witness") == 0){
+                    outputFormat = OUTPUT_WITNESS;
+                } else if(strcmp(optarg, "binary") == 0){
+                    outputFormat = OUTPUT_BINARY;
+                } else {
+                    fprintf(stderr, "Unknown output format %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'p':
+                progressInterval = atoi(optarg);
+                break;
+            case 'r':
+                if(strcmp(optarg, "none") == 0){
+                    relabelling = RELABEL_NONE;
+                } else if(strcmp(optarg, "bfs") == 0){
+                    relabelling = RELABEL_BFS;
+                } else if(strcmp(optarg, "degree") == 0){
+                    relabelling = RELABEL_DEGREE;
+                } else if(strcmp(optarg, "partners") == 0){
+                    relabelling = RELABEL_PARTNERS;
+                } else {
+                    fprintf(stderr, "Unknown order %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 's':
+                seedCount = atoi(optarg);
+                break;
+            case 't':
+                reportTime = TRUE;
+                break;
+            case 'P':
+                if(optarg == NULL){
+                    perfMode = PERF_RUN;
+                } else if(strcmp(optarg, "graph") == 0){
+                    perfMode = PERF_GRAPH;
+                } else {
+                    fprintf(stderr, "Unknown argument %s for --perf.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -702,37 +3138,172 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    unsigned long long int numberOfGraphs = 0;
-    unsigned long long int numberOfUncoveredGraphs = 0;
-
+    hasBudget = timeBudget > 0.0 || nodeBudget > 0;
+    if(hasBudget && deferredFileName == NULL){
+        fprintf(stderr, "A budget requires a file for the deferred graphs.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    
+    if(isomorphismCacheSize > 0 && certificateFile != NULL){
+        fprintf(stderr, "The isomorphism cache cannot be combined with certificates.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    if(tupleFile != NULL && (hasBudget || certificateFile != NULL || isomorphismCacheSize > 0)){
+        fprintf(stderr, "Enumerating all tuples cannot be combined with a budget, certificates\n");
+        fprintf(stderr, "or the isomorphism cache.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    if(perfMode != PERF_OFF && tupleFile != NULL){
+        fprintf(stderr, "The performance counters cannot be combined with --all.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    if(flipFile != NULL && (tupleFile != NULL || certificateFile != NULL ||
+            relabelling != RELABEL_NONE || isomorphismCacheSize > 0)){
+        fprintf(stderr, "Edge flips cannot be combined with --all, certificates, relabelling\n");
+        fprintf(stderr, "or the isomorphism cache.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    if(maximumStoredOpds < 0){
+        maximumStoredOpds = 0;
+    }
+    if(flipFile != NULL || (maximumStoredOpds > 0 && evictionPolicy == EVICT_LRU)){
+        moveHitsToFront = TRUE;
+    }
+    if(tupleFile != NULL){
+        fprintf(tupleFile, ">>eopd_tuples<<");
+        fputc(tupleSize, tupleFile);
+        if(threadCount < 1){
+            threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+        }
+        if(threadCount < 1){
+            threadCount = 1;
+        } else if(threadCount > MAX_THREADS){
+            threadCount = MAX_THREADS;
+        }
+        startCountingThreads();
+    }
+    if(isomorphismCacheSize > 0){
+        isomorphismCache = calloc(isomorphismCacheSize, sizeof(ISOMORPHISM_CACHE_ENTRY));
+        if(isomorphismCache == NULL){
+            fprintf(stderr, "Insufficient memory for the isomorphism cache -- exiting!\n");
+            return EXIT_FAILURE;
+        }
+    }
+    
+    if(perfMode != PERF_OFF && !startPerfCounters()){
+        fprintf(stderr, "Could not open the hardware performance counters -- continuing without --perf.\n");
+        perfMode = PERF_OFF;
+    }
+    
     /*=========== read planar graphs ===========*/
 
-    unsigned short code[MAXCODELENGTH];
-    int length;
-    while (readPlanarCode(code, &length, stdin)) {
-        decodePlanarCode(code);
-        if(findUncoveredFaceTuple()){
-            writePlanarCode();
-            numberOfUncoveredGraphs++;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &runStart);
+    startProgressReporting(progressInterval);
+    
+    int fileCount = argc - optind;
+    char *standardIn = "-";
+    char **fileNames = fileCount ? argv + optind : &standardIn;
+    for(i = 0; i < (fileCount ? fileCount : 1); i++){
+        INPUT input;
+        if(!openInput(&input, fileNames[i])){
+            fprintf(stderr, "Could not open %s -- exiting!\n", fileNames[i]);
+            return EXIT_FAILURE;
         }
-        numberOfGraphs++;
+        struct timespec fileStart, fileEnd;
+        unsigned long long int graphsBefore = numberOfGraphs;
+        unsigned long long int uncoveredGraphsBefore = numberOfUncoveredGraphs;
+        unsigned long long int deferredGraphsBefore = numberOfDeferredGraphs;
+        clock_gettime(CLOCK_MONOTONIC, &fileStart);
+        boolean readNextInput = checkInput(&input);
+        clock_gettime(CLOCK_MONOTONIC, &fileEnd);
+        closeInput(&input);
+        if(fileCount){
+            fprintf(stderr, "%s: read %llu, uncovered %llu, deferred %llu, %.6f seconds.\n",
+                    input.name, numberOfGraphs - graphsBefore,
+                    numberOfUncoveredGraphs - uncoveredGraphsBefore,
+                    numberOfDeferredGraphs - deferredGraphsBefore,
+                    (fileEnd.tv_sec - fileStart.tv_sec) + (fileEnd.tv_nsec - fileStart.tv_nsec) / 1e9);
+        }
+        if(!readNextInput){
+            break;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    if(certificateFile != NULL){
+        fclose(certificateFile);
+    }
+    if(tupleFile != NULL){
+        stopCountingThreads();
+        fclose(tupleFile);
+    }
+    if(flipFile != NULL){
+        fclose(flipFile);
     }
     
     fprintf(stderr, "Read %llu graph%s.\n", numberOfGraphs, 
                 numberOfGraphs==1 ? "" : "s");
     fprintf(stderr, "Written %llu uncovered graph%s.\n", numberOfUncoveredGraphs, 
                 numberOfUncoveredGraphs==1 ? "" : "s");
+    if(tupleFile != NULL){
+        fprintf(stderr, "Found %llu uncovered tuple%s.\n", numberOfUncoveredTuples,
+                numberOfUncoveredTuples==1 ? "" : "s");
+    }
+    if(flipFile != NULL){
+        fprintf(stderr, "Applied %llu flip%s, skipped %llu flip%s.\n",
+                numberOfFlips, numberOfFlips==1 ? "" : "s",
+                numberOfSkippedFlips, numberOfSkippedFlips==1 ? "" : "s");
+        fprintf(stderr, "Invalidated %llu stored OPD%s.\n", numberOfInvalidatedOpds,
+                numberOfInvalidatedOpds==1 ? "" : "'s");
+    }
+    if(hasBudget){
+        fprintf(stderr, "Deferred %llu graph%s to %s.\n", numberOfDeferredGraphs, 
+                numberOfDeferredGraphs==1 ? "" : "s", deferredFileName);
+    }
     
-    fprintf(stderr, "Checked %llu 3-tuple%s.\nChecked %llu 4-tuple%s.\n",
-            numberOfChecked3Tuples, numberOfChecked3Tuples==1 ? "" : "s",
-            numberOfChecked4Tuples, numberOfChecked4Tuples==1 ? "" : "s");
+    for(i = MIN_TUPLE_SIZE; i <= tupleSize; i++){
+        fprintf(stderr, "Checked %llu %d-tuple%s.\n",
+                numberOfCheckedTuples[i], i, numberOfCheckedTuples[i]==1 ? "" : "s");
+    }
     fprintf(stderr, "%llu tuple%s where covered by a stored OPD with extension.\n",
             numberOfTuplesCoveredByStoredOpd, numberOfTuplesCoveredByStoredOpd==1 ? "" : "s");
-    unsigned long long int remaining = numberOfChecked3Tuples + numberOfChecked4Tuples
+    unsigned long long int remaining = numberOfCheckedTuplesTotal()
                 - numberOfTuplesCoveredByStoredOpd;
     fprintf(stderr, "Searched eOPD for %llu tuple%s.\n",
             remaining, remaining==1 ? "" : "s");
+    fprintf(stderr, "Visited %llu node%s in the search for new eOPD's.\n",
+            numberOfEopdNodes, numberOfEopdNodes==1 ? "" : "s");
+    if(lookahead){
+        fprintf(stderr, "Pruned %llu node%s from which no remaining face could be reached.\n",
+                numberOfPrunedNodes, numberOfPrunedNodes==1 ? "" : "s");
+    }
     fprintf(stderr, "Used a maximum of %d OPD%s per triangulation.\n",
             maximumOpdCount, maximumOpdCount==1 ? "" : "'s");
+    fprintf(stderr, "Removed %llu dominated OPD%s.\n",
+            numberOfDominatedOpds, numberOfDominatedOpds==1 ? "" : "'s");
+    if(maximumStoredOpds > 0){
+        fprintf(stderr, "Evicted %llu stored OPD%s.\n",
+                numberOfEvictedOpds, numberOfEvictedOpds==1 ? "" : "'s");
+    }
+    if(isomorphismCacheSize > 0){
+        fprintf(stderr, "Found %llu of %llu graph%s in the isomorphism cache (hit rate %.4f).\n",
+                numberOfIsomorphismCacheHits, numberOfIsomorphismCacheLookups,
+                numberOfIsomorphismCacheLookups==1 ? "" : "s",
+                numberOfIsomorphismCacheLookups ?
+                (double) numberOfIsomorphismCacheHits / numberOfIsomorphismCacheLookups : 0.0);
+    }
+    if(perfMode != PERF_OFF){
+        printPerfCounters();
+    }
+    if(reportTime){
+        fprintf(stderr, "Spent %.6f seconds reading and checking graphs.\n",
+                (end.tv_sec - runStart.tv_sec) + (end.tv_nsec - runStart.tv_nsec) / 1e9);
+    }
     return EXIT_SUCCESS;
 }
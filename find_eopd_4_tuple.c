@@ -12,7 +12,7 @@
  * 
  * Compile with:
  *     
- *     cc -o find_eopd_4_tuple -O4 find_eopd_4_tuple.c
+ *     cc -o find_eopd_4_tuple -O4 -pthread find_eopd_4_tuple.c
  * 
  */
 
@@ -20,6 +20,12 @@
 #include <stdio.h>
 #include <getopt.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
 
 
 #define MAXN 34            /* the maximum number of vertices */
@@ -61,6 +67,8 @@ typedef unsigned long long int bitset;
 #define SAFE_REMOVE(s, el) ADD(s, el); REMOVE(s, el)
 #define SAFE_REMOVE_ALL(s, elements) ADD_ALL(s, elements); REMOVE_ALL(s, elements)
 
+#define SIZE(s) __builtin_popcountll(s)
+
 
 typedef struct e /* The data type used for edges */ {
     int start; /* vertex where the edge starts */
@@ -157,13 +165,222 @@ void printVertexTuple(bitset tuple){
 
 ////////END DEBUGGING METHODS
 
+//=============== Witnesses ===========================
+
+/* By default the first eOPD that is found is printed. With --all every
+ * eOPD that the search reaches is printed, i.e., every eOPD in which the
+ * last face that was added is the first one that brings a second face of
+ * the tuple into the disc. With --smallest an eOPD with as few faces as
+ * possible is printed, found by iterative deepening on the number of
+ * faces.
+ *
+ * In these modes the search remembers the states it has visited. A state
+ * consists of the faces of the eOPD and the last extended edge. As long
+ * as the eOPD contains only one face of the tuple, this face is the
+ * extension, so the state determines the rest of the search and a state
+ * that was visited before can be skipped. The visited states are kept per
+ * thread in a hash table with linear probing.
+ */
+
+#define FIRST_WITNESS 0
+#define ALL_WITNESSES 1
+#define SMALLEST_WITNESS 2
+
+int witnessMode = FIRST_WITNESS;
+int faceLimit = MAXF + 1; //the maximum number of faces of an eOPD
+
+typedef struct {
+    bitset faces; /* EMPTY_SET for an unused entry */
+    EDGE *lastExtendedEdge;
+} SEARCH_STATE;
+
+__thread SEARCH_STATE *visitedStates = NULL;
+__thread int visitedStateCount;
+__thread int visitedStateCapacity;
+
+unsigned long long int numberOfVisitedStates = 0;
+
+bitset *witnesses = NULL;
+int witnessCount = 0;
+int witnessCapacity = 0;
+pthread_mutex_t witnessMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void *allocateOrExit(size_t count, size_t size){
+    void *array = calloc(count, size);
+    if(array == NULL){
+        fprintf(stderr, "Insufficient memory for the visited states -- exiting!\n");
+        exit(1);
+    }
+    return array;
+}
+
+/* The finalizer of splitmix64, which spreads the bits of a bitset over
+ * the whole word, so that the low bits can be used as hash.
+ */
+static inline unsigned long long int mixBits(unsigned long long int z){
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline unsigned long long int hashSearchState(bitset faces, EDGE *lastExtendedEdge){
+    return mixBits(faces ^ ((unsigned long long int) (lastExtendedEdge - edges) << 56));
+}
+
+void insertSearchState(SEARCH_STATE *table, int capacity, bitset faces, EDGE *lastExtendedEdge){
+    int i = hashSearchState(faces, lastExtendedEdge) & (capacity - 1);
+    while(table[i].faces != EMPTY_SET){
+        i = (i + 1) & (capacity - 1);
+    }
+    table[i].faces = faces;
+    table[i].lastExtendedEdge = lastExtendedEdge;
+}
+
+void growVisitedStates(){
+    int i;
+    int capacity = 2 * visitedStateCapacity;
+    SEARCH_STATE *table = allocateOrExit(capacity, sizeof(SEARCH_STATE));
+    for(i = 0; i < visitedStateCapacity; i++){
+        if(visitedStates[i].faces != EMPTY_SET){
+            insertSearchState(table, capacity,
+                    visitedStates[i].faces, visitedStates[i].lastExtendedEdge);
+        }
+    }
+    free(visitedStates);
+    visitedStates = table;
+    visitedStateCapacity = capacity;
+}
+
+/* Marks the state as visited. Returns FALSE if it was already visited.
+ */
+boolean visitSearchState(bitset faces, EDGE *lastExtendedEdge){
+    if(2 * (visitedStateCount + 1) > visitedStateCapacity){
+        growVisitedStates();
+    }
+    int i = hashSearchState(faces, lastExtendedEdge) & (visitedStateCapacity - 1);
+    while(visitedStates[i].faces != EMPTY_SET){
+        if(visitedStates[i].faces == faces &&
+                visitedStates[i].lastExtendedEdge == lastExtendedEdge){
+            return FALSE;
+        }
+        i = (i + 1) & (visitedStateCapacity - 1);
+    }
+    visitedStates[i].faces = faces;
+    visitedStates[i].lastExtendedEdge = lastExtendedEdge;
+    visitedStateCount++;
+    return TRUE;
+}
+
+void startVisitedStates(){
+    visitedStateCapacity = 1024;
+    visitedStateCount = 0;
+    visitedStates = allocateOrExit(visitedStateCapacity, sizeof(SEARCH_STATE));
+}
+
+void stopVisitedStates(){
+    __sync_fetch_and_add(&numberOfVisitedStates, visitedStateCount);
+    free(visitedStates);
+    visitedStates = NULL;
+}
+
+void storeWitness(bitset faces){
+    pthread_mutex_lock(&witnessMutex);
+    if(witnessCount == witnessCapacity){
+        witnessCapacity = witnessCapacity ? 2 * witnessCapacity : 64;
+        witnesses = realloc(witnesses, witnessCapacity * sizeof(bitset));
+        if(witnesses == NULL){
+            fprintf(stderr, "Insufficient memory for the eOPD's -- exiting!\n");
+            exit(1);
+        }
+    }
+    witnesses[witnessCount++] = faces;
+    pthread_mutex_unlock(&witnessMutex);
+}
+
+/* Orders the eOPD's by their number of faces and then by their faces.
+ */
+int compareWitnesses(const void *a, const void *b){
+    bitset w1 = *(const bitset *) a;
+    bitset w2 = *(const bitset *) b;
+    if(SIZE(w1) != SIZE(w2)){
+        return SIZE(w1) - SIZE(w2);
+    }
+    return w1 < w2 ? -1 : (w1 > w2);
+}
+
+/* Sorts the stored eOPD's and removes the duplicates. The eOPD's are found
+ * in an order that depends on the threads, so this makes the order of the
+ * output independent of the threads.
+ */
+void sortWitnesses(){
+    int i, count = 0;
+    qsort(witnesses, witnessCount, sizeof(bitset), compareWitnesses);
+    for(i = 0; i < witnessCount; i++){
+        if(count == 0 || witnesses[i] != witnesses[count - 1]){
+            witnesses[count++] = witnesses[i];
+        }
+    }
+    witnessCount = count;
+}
+
+void printWitnesses(){
+    int i;
+    for(i = 0; i < witnessCount; i++){
+        fprintf(stderr, "eOPD %d (%d faces):\n", i + 1, SIZE(witnesses[i]));
+        printFaceTupleFaces(witnesses[i]);
+    }
+    fprintf(stderr, "Found %d distinct eOPD%s.\n", witnessCount, witnessCount==1 ? "" : "'s");
+}
+
+//=============== Searching eOPD's ===========================
+
+/* Each face of the tuple is tried as the extension, with each of its
+ * edges as the shared edge. These roots of the search are independent,
+ * and are divided over a number of threads. The roots are handed out in
+ * order, and the search from a root is abandoned as soon as an eOPD is
+ * found from a root with a smaller index. So the eOPD that is printed is
+ * always the one from the first successful root, as in a sequential
+ * search, independent of the number of threads.
+ */
+
+#define MAX_THREADS 256
+#define MAX_ROOTS (3*MAXF)
+
+int threadCount = 0;
+
+bitset searchedTuple;
+bitset eopdFaces; //the faces of the eOPD that was found
+int rootExtension[MAX_ROOTS];
+EDGE *rootSharedEdge[MAX_ROOTS];
+bitset rootEopdFaces[MAX_ROOTS]; //the faces of the eOPD found from root i
+int rootCount;
+int nextRoot;
+volatile int firstSuccessfulRoot; //rootCount as long as no eOPD was found
+
+__thread int currentRoot;
+
 boolean findEOPD_impl(bitset currentEopdVertices, bitset currentEopdFaces, int eopdExtension, bitset remainingFaces, EDGE *lastExtendedEdge){
+    //stop if an earlier root already found an eOPD
+    if(firstSuccessfulRoot < currentRoot){
+        return FALSE;
+    }
+    
     //first check whether this is a covering eOPD
     if(IS_NOT_EMPTY(INTERSECTION(currentEopdFaces, remainingFaces))){
-        printFaceTupleFaces(currentEopdFaces);
+        if(witnessMode == ALL_WITNESSES){
+            storeWitness(currentEopdFaces);
+            return FALSE;
+        }
+        rootEopdFaces[currentRoot] = currentEopdFaces;
         return TRUE;
     }
     
+    if(witnessMode != FIRST_WITNESS &&
+            (SIZE(currentEopdFaces) >= faceLimit ||
+            !visitSearchState(currentEopdFaces, lastExtendedEdge))){
+        return FALSE;
+    }
+    
     //otherwise try extending the eOPD
     EDGE *extension = lastExtendedEdge->next;
     
@@ -192,34 +409,129 @@ boolean findEOPD_impl(bitset currentEopdVertices, bitset currentEopdFaces, int e
     return FALSE;
 }
 
+void storeSuccessfulRoot(int root){
+    int first;
+    while(root < (first = firstSuccessfulRoot) &&
+            !__sync_bool_compare_and_swap(&firstSuccessfulRoot, first, root));
+}
+
+void *searchRootsInThread(void *argument){
+    int root;
+    (void) argument;
+    if(witnessMode != FIRST_WITNESS){
+        startVisitedStates();
+    }
+    while((root = __sync_fetch_and_add(&nextRoot, 1)) < firstSuccessfulRoot){
+        currentRoot = root;
+        int i = rootExtension[root];
+        //construct initial eopd
+        int neighbouringFace = rootSharedEdge[root]->inverse->rightface;
+        bitset currentEopdVertices = faceSets[neighbouringFace];
+        bitset currentEopdFaces = UNION(SINGLETON(i), SINGLETON(neighbouringFace));
+        if(findEOPD_impl(currentEopdVertices, currentEopdFaces, i, MINUS(searchedTuple, i),
+                rootSharedEdge[root]->inverse)){
+            storeSuccessfulRoot(root);
+        }
+    }
+    if(witnessMode != FIRST_WITNESS){
+        stopVisitedStates();
+    }
+    return NULL;
+}
+
+void searchRoots(){
+    int i;
+    pthread_t threads[MAX_THREADS];
+    
+    nextRoot = 0;
+    firstSuccessfulRoot = rootCount;
+    
+    int count = threadCount < rootCount ? threadCount : rootCount;
+    if(count <= 1){
+        searchRootsInThread(NULL);
+    } else {
+        for(i = 0; i < count; i++){
+            if(pthread_create(threads + i, NULL, searchRootsInThread, NULL)){
+                fprintf(stderr, "Could not create thread -- exiting!\n");
+                exit(1);
+            }
+        }
+        for(i = 0; i < count; i++){
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
 boolean findEOPD(bitset tuple){
     int i, j;
     
+    rootCount = 0;
     for(i = 0; i < nf; i++){
         if(CONTAINS(tuple, i)){
             //try to find a eOPD with face i as extension
-            bitset remainingFaces = MINUS(tuple, i);
             //we use each edge once as a possible shared edge 
             EDGE *sharedEdge = facestart[i];
             for(j = 0; j < 3; j++){
-                //construct initial eopd
-                int neighbouringFace = sharedEdge->inverse->rightface;
-                bitset currentEopdVertices = faceSets[neighbouringFace];
-                bitset currentEopdFaces = UNION(SINGLETON(i), SINGLETON(neighbouringFace));
-                if(findEOPD_impl(currentEopdVertices, currentEopdFaces, i, remainingFaces, sharedEdge->inverse)){
-                    return TRUE;
-                }
+                rootExtension[rootCount] = i;
+                rootSharedEdge[rootCount] = sharedEdge;
+                rootCount++;
                 sharedEdge = sharedEdge->next->inverse;
             }
         }
     }
-    return FALSE;
+    searchedTuple = tuple;
+    faceLimit = MAXF + 1;
+    witnessCount = 0;
+    searchRoots();
+    
+    if(witnessMode == ALL_WITNESSES){
+        sortWitnesses();
+        return witnessCount > 0;
+    }
+    if(firstSuccessfulRoot == rootCount){
+        return FALSE;
+    }
+    bitset witness = rootEopdFaces[firstSuccessfulRoot];
+    
+    if(witnessMode == SMALLEST_WITNESS){
+        //look for a smaller eOPD by iterative deepening
+        for(faceLimit = 2; faceLimit < SIZE(witness); faceLimit++){
+            searchRoots();
+            if(firstSuccessfulRoot < rootCount){
+                witness = rootEopdFaces[firstSuccessfulRoot];
+                break;
+            }
+        }
+    }
+    eopdFaces = witness;
+    return TRUE;
 }
 
 //=============== Reading and decoding planarcode ===========================
 
 EDGE *edgeMatrix[MAXN][MAXN];
 
+/* The faces are indexed by their vertices in a hash table with linear
+ * probing, so that the faces of a tuple can be looked up quickly.
+ */
+#define FACE_INDEX_SIZE 128 /* a power of two that is at least 2*MAXF */
+
+int faceIndex[FACE_INDEX_SIZE]; /* a face, or -1 for an unused entry */
+
+void buildFaceIndex(){
+    int i;
+    for(i = 0; i < FACE_INDEX_SIZE; i++){
+        faceIndex[i] = -1;
+    }
+    for(i = 0; i < nf; i++){
+        int j = mixBits(faceSets[i]) & (FACE_INDEX_SIZE - 1);
+        while(faceIndex[j] != -1){
+            j = (j + 1) & (FACE_INDEX_SIZE - 1);
+        }
+        faceIndex[j] = i;
+    }
+}
+
 /* Store in the rightface field of each edge the number of the face on
    the right hand side of that edge.  Faces are numbered 0,1,....  Also
    store in facestart[i] an example of an edge in the clockwise orientation
@@ -253,6 +565,37 @@ void makeDual() {
             e = e->next;
         } while (e != ex);
     }
+    
+    buildFaceIndex();
+}
+
+/* Returns the face with the given vertices, or -1 if there is no such face.
+ */
+int findFace(bitset vertices){
+    int j = mixBits(vertices) & (FACE_INDEX_SIZE - 1);
+    while(faceIndex[j] != -1){
+        if(faceSets[faceIndex[j]] == vertices){
+            return faceIndex[j];
+        }
+        j = (j + 1) & (FACE_INDEX_SIZE - 1);
+    }
+    return -1;
+}
+
+/* Returns the face with the vertices in triangle, which has the format
+ * u,v,w. Returns -1 if triangle cannot be read, and -2 if there is no
+ * such face.
+ */
+int readFace(char *triangle, int *t1, int *t2, int *t3){
+    if(sscanf(triangle, "%d,%d,%d", t1, t2, t3)!=3){
+        return -1;
+    }
+    if(*t1 < 1 || *t1 > nv || *t2 < 1 || *t2 > nv || *t3 < 1 || *t3 > nv){
+        return -2;
+    }
+    bitset vertices = UNION(SINGLETON(*t1 - 1), UNION(SINGLETON(*t2 - 1), SINGLETON(*t3 - 1)));
+    int face = findFace(vertices);
+    return face == -1 ? -2 : face;
 }
 
 void decodePlanarCode(unsigned short* code) {
@@ -439,20 +782,532 @@ int readPlanarCode(unsigned short code[], int *length, FILE *file) {
     return (1);
 }
 
+//=============== Query server ===========================
+
+/* With --socket the program does not read a graph from standard in, but
+ * answers requests on a Unix domain socket, so that many tuples can be
+ * checked without starting a new process for each of them. The
+ * connections are handled one after the other, and each connection can
+ * contain any number of requests, each on its own line:
+ *
+ *     load n        followed by n bytes with one graph in planar_code (the
+ *                   header is optional); answer: graph <hash>
+ *     query <hash> u1,v1,w1 ... un,vn,wn
+ *                   answer: covered <k> followed by k lines with the faces
+ *                   of an eOPD in the same format, or uncovered
+ *     quit          closes the connection
+ *     shutdown      stops the server
+ *
+ * Errors are answered with error <message>. The decoded graphs are kept in
+ * a cache of at most graphCacheSize graphs, keyed by a hash of their
+ * planar code, and the least recently used graph is removed when the cache
+ * is full. A graph is not loaded if a different graph with the same hash
+ * is in the cache. For each graph the eOPD's that were found are kept as well, and
+ * without --all or --smallest a query is answered with such an eOPD if it
+ * contains two faces of the tuple, so the answer can differ from the one
+ * for a single query.
+ */
+
+typedef struct {
+    EDGE edges[MAXE];
+    EDGE *firstedge[MAXN];
+    int degree[MAXN];
+    bitset neighbourhood[MAXN];
+    EDGE *facestart[MAXF];
+    int faceSize[MAXF];
+    bitset faceSets[MAXF];
+    int faceIndex[FACE_INDEX_SIZE];
+    int nv, ne, nf;
+} GRAPH;
+
+typedef struct {
+    unsigned long long int hash;
+    int codeLength;
+    unsigned short code[MAXCODELENGTH];
+    GRAPH graph;
+    bitset *eopds; //the eOPD's that were found for this graph
+    int eopdCount;
+    int eopdCapacity;
+    unsigned long long int lastUse; /* 0 for an unused entry */
+} GRAPH_CACHE_ENTRY;
+
+int graphCacheSize = 256;
+GRAPH_CACHE_ENTRY *graphCache = NULL;
+GRAPH_CACHE_ENTRY *currentGraph = NULL; //the graph in the global variables
+unsigned long long int lastGraphUse = 0;
+
+void saveGraph(GRAPH *graph){
+    memcpy(graph->edges, edges, ne * sizeof(EDGE));
+    memcpy(graph->firstedge, firstedge, nv * sizeof(EDGE *));
+    memcpy(graph->degree, degree, nv * sizeof(int));
+    memcpy(graph->neighbourhood, neighbourhood, nv * sizeof(bitset));
+    memcpy(graph->facestart, facestart, nf * sizeof(EDGE *));
+    memcpy(graph->faceSize, faceSize, nf * sizeof(int));
+    memcpy(graph->faceSets, faceSets, nf * sizeof(bitset));
+    memcpy(graph->faceIndex, faceIndex, FACE_INDEX_SIZE * sizeof(int));
+    graph->nv = nv;
+    graph->ne = ne;
+    graph->nf = nf;
+}
+
+/* Copies the graph back into the global variables. The edges are copied
+ * to the same addresses they were saved from, so the pointers between
+ * them stay valid.
+ */
+void restoreGraph(GRAPH *graph){
+    nv = graph->nv;
+    ne = graph->ne;
+    nf = graph->nf;
+    memcpy(edges, graph->edges, ne * sizeof(EDGE));
+    memcpy(firstedge, graph->firstedge, nv * sizeof(EDGE *));
+    memcpy(degree, graph->degree, nv * sizeof(int));
+    memcpy(neighbourhood, graph->neighbourhood, nv * sizeof(bitset));
+    memcpy(facestart, graph->facestart, nf * sizeof(EDGE *));
+    memcpy(faceSize, graph->faceSize, nf * sizeof(int));
+    memcpy(faceSets, graph->faceSets, nf * sizeof(bitset));
+    memcpy(faceIndex, graph->faceIndex, FACE_INDEX_SIZE * sizeof(int));
+}
+
+unsigned long long int hashPlanarCode(unsigned short *code, int length){
+    int i;
+    unsigned long long int hash = 14695981039346656037ULL;
+    for(i = 0; i < length; i++){
+        hash = (hash ^ code[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+GRAPH_CACHE_ENTRY *findCachedGraph(unsigned long long int hash){
+    int i;
+    for(i = 0; i < graphCacheSize; i++){
+        if(graphCache[i].lastUse && graphCache[i].hash == hash){
+            return graphCache + i;
+        }
+    }
+    return NULL;
+}
+
+/* Makes the graph in entry the current graph.
+ */
+void useCachedGraph(GRAPH_CACHE_ENTRY *entry){
+    if(entry != currentGraph){
+        restoreGraph(&(entry->graph));
+        currentGraph = entry;
+    }
+    entry->lastUse = ++lastGraphUse;
+}
+
+/* Adds the graph with the given code to the cache, unless it is already
+ * there, and makes it the current graph. The hash identifies a graph in
+ * the queries, so it has to be unique: returns NULL if another graph with
+ * the same hash is in the cache.
+ */
+GRAPH_CACHE_ENTRY *loadCachedGraph(unsigned short *code, int length){
+    int i;
+    unsigned long long int hash = hashPlanarCode(code, length);
+    GRAPH_CACHE_ENTRY *entry = findCachedGraph(hash);
+    if(entry != NULL){
+        if(entry->codeLength != length ||
+                memcmp(entry->code, code, length * sizeof(unsigned short))){
+            return NULL;
+        }
+        useCachedGraph(entry);
+        return entry;
+    }
+    
+    //replace the least recently used graph
+    entry = graphCache;
+    for(i = 1; i < graphCacheSize && entry->lastUse; i++){
+        if(graphCache[i].lastUse < entry->lastUse){
+            entry = graphCache + i;
+        }
+    }
+    decodePlanarCode(code);
+    entry->hash = hash;
+    entry->codeLength = length;
+    memcpy(entry->code, code, length * sizeof(unsigned short));
+    saveGraph(&(entry->graph));
+    entry->eopdCount = 0;
+    currentGraph = entry;
+    entry->lastUse = ++lastGraphUse;
+    return entry;
+}
+
+void storeCachedEopd(GRAPH_CACHE_ENTRY *entry, bitset faces){
+    if(entry->eopdCount == entry->eopdCapacity){
+        entry->eopdCapacity = entry->eopdCapacity ? 2 * entry->eopdCapacity : 16;
+        entry->eopds = realloc(entry->eopds, entry->eopdCapacity * sizeof(bitset));
+        if(entry->eopds == NULL){
+            fprintf(stderr, "Insufficient memory for the eOPD's -- exiting!\n");
+            exit(1);
+        }
+    }
+    entry->eopds[entry->eopdCount++] = faces;
+}
+
+/* Returns the index of a stored eOPD that contains two faces of the
+ * tuple, or -1 if there is no such eOPD.
+ */
+int findCachedEopd(GRAPH_CACHE_ENTRY *entry, bitset tuple){
+    int i;
+    for(i = 0; i < entry->eopdCount; i++){
+        if(HAS_MORE_THAN_ONE_ELEMENT(INTERSECTION(entry->eopds[i], tuple))){
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Checks the planar code of one graph in the single byte format, so that
+ * it can be decoded safely: each vertex needs at least three neighbours,
+ * which are valid vertices, each edge needs to occur in both directions,
+ * and the number of edges is that of a triangulation. Finally the graph
+ * needs to be connected and each face of the rotation system needs to be
+ * a triangle, which together with the number of edges implies that the
+ * code describes a plane triangulation. Stores the code without header
+ * in code.
+ */
+boolean readGraphFromBytes(unsigned char *bytes, int byteCount, unsigned short *code, int *length){
+    int i, v, position;
+    boolean adjacent[MAXN][MAXN];
+    int rotation[MAXN][MAXVAL];
+    int rotationDegree[MAXN];
+    int rotationIndex[MAXN][MAXN]; /* the position of w in the rotation of v */
+    
+    //skip the header
+    if(byteCount >= 15 && !memcmp(bytes, ">>planar_code", 13)){
+        for(i = 13; i < byteCount - 1 && !(bytes[i] == '<' && bytes[i + 1] == '<'); i++);
+        bytes += i + 2;
+        byteCount -= i + 2;
+    }
+    if(byteCount < 1 || bytes[0] < 4 || bytes[0] > MAXN || byteCount > MAXCODELENGTH){
+        return FALSE;
+    }
+    int n = bytes[0];
+    memset(adjacent, 0, sizeof(adjacent));
+    code[0] = n;
+    position = 1;
+    for(v = 0; v < n; v++){
+        int count = 0;
+        while(position < byteCount && bytes[position] != 0){
+            int w = bytes[position] - 1;
+            if(w >= n || w == v || adjacent[v][w] || ++count > MAXVAL){
+                return FALSE;
+            }
+            adjacent[v][w] = TRUE;
+            rotationIndex[v][w] = count - 1;
+            rotation[v][count - 1] = w;
+            code[position] = bytes[position];
+            position++;
+        }
+        if(position == byteCount || count < 3){
+            return FALSE;
+        }
+        rotationDegree[v] = count;
+        code[position] = 0;
+        position++;
+    }
+    //a triangulation has 3n-6 edges
+    if(position != byteCount || position - 1 - n != 6*n - 12){
+        return FALSE;
+    }
+    for(v = 0; v < n; v++){
+        for(i = 0; i < n; i++){
+            if(adjacent[v][i] != adjacent[i][v]){
+                return FALSE;
+            }
+        }
+    }
+    //the face to the right of the edge vw continues with the edge before
+    //v in the clockwise rotation of w, as in makeDual()
+    for(v = 0; v < n; v++){
+        for(i = 0; i < rotationDegree[v]; i++){
+            int u = v, w = rotation[v][i], x;
+            int size = 0;
+            do {
+                x = rotation[w][(rotationIndex[w][u] + rotationDegree[w] - 1) % rotationDegree[w]];
+                u = w;
+                w = x;
+                size++;
+            } while((u != v || w != rotation[v][i]) && size <= 3);
+            if(size != 3){
+                return FALSE;
+            }
+        }
+    }
+    int stack[MAXN];
+    int stackSize = 1;
+    int reachedCount = 1;
+    bitset reached = SINGLETON(0);
+    stack[0] = 0;
+    while(stackSize > 0){
+        v = stack[--stackSize];
+        for(i = 0; i < rotationDegree[v]; i++){
+            if(!CONTAINS(reached, rotation[v][i])){
+                ADD(reached, rotation[v][i]);
+                stack[stackSize++] = rotation[v][i];
+                reachedCount++;
+            }
+        }
+    }
+    if(reachedCount != n){
+        return FALSE;
+    }
+    *length = position;
+    return TRUE;
+}
+
+/* Writes the faces in the format of the arguments of this program.
+ */
+void writeFaces(FILE *file, bitset faces){
+    int i, j;
+    boolean first = TRUE;
+    for(i = 0; i < nf; i++){
+        if(CONTAINS(faces, i)){
+            fprintf(file, "%s", first ? "" : " ");
+            first = FALSE;
+            int separator = 0;
+            for(j = 0; j < nv; j++){
+                if(CONTAINS(faceSets[i], j)){
+                    fprintf(file, "%s%d", separator++ ? "," : "", j+1);
+                }
+            }
+        }
+    }
+    fprintf(file, "\n");
+}
+
+void answerLoad(FILE *in, FILE *out, char *arguments){
+    unsigned char bytes[MAXCODELENGTH + 64];
+    unsigned short code[MAXCODELENGTH];
+    int length;
+    char *end;
+    long byteCount = strtol(arguments, &end, 10);
+    if(end == arguments || byteCount < 1 || byteCount > (long) sizeof(bytes)){
+        fprintf(out, "error invalid number of bytes\n");
+        return;
+    }
+    if(fread(bytes, 1, byteCount, in) != (size_t) byteCount){
+        fprintf(out, "error unexpected end of graph\n");
+        return;
+    }
+    if(!readGraphFromBytes(bytes, byteCount, code, &length)){
+        fprintf(out, "error invalid planar code\n");
+        return;
+    }
+    GRAPH_CACHE_ENTRY *entry = loadCachedGraph(code, length);
+    if(entry == NULL){
+        fprintf(out, "error another cached graph has the same hash\n");
+        return;
+    }
+    fprintf(out, "graph %016llx\n", entry->hash);
+}
+
+void answerQuery(FILE *out, char *arguments){
+    int i, t1, t2, t3;
+    char *triangle;
+    char *end;
+    unsigned long long int hash = strtoull(arguments, &end, 16);
+    GRAPH_CACHE_ENTRY *entry = end == arguments ? NULL : findCachedGraph(hash);
+    if(entry == NULL){
+        fprintf(out, "error unknown graph\n");
+        return;
+    }
+    useCachedGraph(entry);
+    
+    bitset tuple = EMPTY_SET;
+    for(triangle = strtok(end, " \t\r\n"); triangle != NULL; triangle = strtok(NULL, " \t\r\n")){
+        int face = readFace(triangle, &t1, &t2, &t3);
+        if(face == -1){
+            fprintf(out, "error cannot read triangle %s\n", triangle);
+            return;
+        } else if(face == -2){
+            fprintf(out, "error the triangle %s does not exist\n", triangle);
+            return;
+        }
+        ADD(tuple, face);
+    }
+    if(!HAS_MORE_THAN_ONE_ELEMENT(tuple)){
+        fprintf(out, "error the tuple should contain at least 2 faces\n");
+        return;
+    }
+    
+    if(witnessMode == FIRST_WITNESS){
+        i = findCachedEopd(entry, tuple);
+        if(i >= 0){
+            fprintf(out, "covered 1\n");
+            writeFaces(out, entry->eopds[i]);
+            return;
+        }
+    }
+    if(!findEOPD(tuple)){
+        fprintf(out, "uncovered\n");
+    } else if(witnessMode == ALL_WITNESSES){
+        fprintf(out, "covered %d\n", witnessCount);
+        for(i = 0; i < witnessCount; i++){
+            writeFaces(out, witnesses[i]);
+        }
+    } else {
+        if(witnessMode == FIRST_WITNESS){
+            storeCachedEopd(entry, eopdFaces);
+        }
+        fprintf(out, "covered 1\n");
+        writeFaces(out, eopdFaces);
+    }
+}
+
+/* Answers the requests on one connection. Returns TRUE if the server
+ * should stop.
+ */
+boolean answerRequests(int connection){
+    char line[4096];
+    boolean shutdown = FALSE;
+    FILE *in = fdopen(connection, "r");
+    FILE *out = fdopen(dup(connection), "w");
+    if(in == NULL || out == NULL){
+        fprintf(stderr, "Could not open connection.\n");
+        if(in != NULL){
+            fclose(in);
+        } else {
+            close(connection);
+        }
+        if(out != NULL){
+            fclose(out);
+        }
+        return FALSE;
+    }
+    
+    while(fgets(line, sizeof(line), in) != NULL){
+        char *arguments = line + strcspn(line, " \t\r\n");
+        if(!strncmp(line, "load", arguments - line) && arguments - line == 4){
+            answerLoad(in, out, arguments);
+        } else if(!strncmp(line, "query", arguments - line) && arguments - line == 5){
+            answerQuery(out, arguments);
+        } else if(!strncmp(line, "quit", arguments - line) && arguments - line == 4){
+            break;
+        } else if(!strncmp(line, "shutdown", arguments - line) && arguments - line == 8){
+            shutdown = TRUE;
+            break;
+        } else {
+            fprintf(out, "error unknown request\n");
+        }
+        fflush(out);
+    }
+    
+    fclose(in);
+    fclose(out);
+    return shutdown;
+}
+
+/* Removes a socket that is left behind by a server that stopped. Returns
+ * FALSE if path exists and is not such a socket, so that no other file is
+ * removed.
+ */
+boolean removeStaleSocket(char *path, struct sockaddr_un *address){
+    struct stat status;
+    if(lstat(path, &status) == -1){
+        return TRUE;
+    }
+    if(!S_ISSOCK(status.st_mode)){
+        fprintf(stderr, "%s exists and is not a socket -- exiting!\n", path);
+        return FALSE;
+    }
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(client != -1 && connect(client, (struct sockaddr *) address, sizeof(*address)) == 0){
+        close(client);
+        fprintf(stderr, "Another server is listening on %s -- exiting!\n", path);
+        return FALSE;
+    }
+    if(client != -1){
+        close(client);
+    }
+    unlink(path);
+    return TRUE;
+}
+
+int runServer(char *path){
+    struct sockaddr_un address;
+    struct stat created, status;
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server == -1){
+        perror("Could not create socket");
+        return EXIT_FAILURE;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(strlen(path) >= sizeof(address.sun_path)){
+        fprintf(stderr, "The socket path is too long -- exiting!\n");
+        return EXIT_FAILURE;
+    }
+    strcpy(address.sun_path, path);
+    if(!removeStaleSocket(path, &address)){
+        return EXIT_FAILURE;
+    }
+    if(bind(server, (struct sockaddr *) &address, sizeof(address)) == -1 ||
+            lstat(path, &created) == -1 || listen(server, 16) == -1){
+        perror("Could not listen on socket");
+        return EXIT_FAILURE;
+    }
+    
+    graphCache = calloc(graphCacheSize, sizeof(GRAPH_CACHE_ENTRY));
+    if(graphCache == NULL){
+        fprintf(stderr, "Insufficient memory for the graph cache -- exiting!\n");
+        return EXIT_FAILURE;
+    }
+    
+    //a client that disconnects early should not stop the server
+    signal(SIGPIPE, SIG_IGN);
+    
+    boolean shutdown = FALSE;
+    while(!shutdown){
+        int connection = accept(server, NULL, NULL);
+        if(connection == -1){
+            perror("Could not accept connection");
+            continue;
+        }
+        shutdown = answerRequests(connection);
+    }
+    
+    close(server);
+    //only remove the socket if it is still the one that this server created
+    if(lstat(path, &status) == 0 && S_ISSOCK(status.st_mode) &&
+            status.st_dev == created.st_dev && status.st_ino == created.st_ino){
+        unlink(path);
+    }
+    return EXIT_SUCCESS;
+}
+
 //====================== USAGE =======================
 
 void help(char *name) {
     fprintf(stderr, "The program %s finds an extended outer planar discs in a plane triangulation.\n\n", name);
     fprintf(stderr, "Usage\n=====\n");
-    fprintf(stderr, " %s [options] u1,v1,w1 ... un,vn,wn\n\n", name);
+    fprintf(stderr, " %s [options] u1,v1,w1 ... un,vn,wn\n", name);
+    fprintf(stderr, " %s [options] -u path\n\n", name);
     fprintf(stderr, "\nThis program can handle graphs up to %d vertices.\n\n", MAXN);
     fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -a, --all\n");
+    fprintf(stderr, "       Print all distinct eOPD's that the search reaches, ordered by their\n");
+    fprintf(stderr, "       number of faces, instead of the first one.\n");
+    fprintf(stderr, "    -s, --smallest\n");
+    fprintf(stderr, "       Print an eOPD with as few faces as possible instead of the first\n");
+    fprintf(stderr, "       one.\n");
+    fprintf(stderr, "    -u, --socket path\n");
+    fprintf(stderr, "       Answer requests on the Unix domain socket path instead of checking\n");
+    fprintf(stderr, "       a single tuple. See the comment above the query server in the\n");
+    fprintf(stderr, "       source for the requests.\n");
+    fprintf(stderr, "    -c, --cache n\n");
+    fprintf(stderr, "       Keep at most n graphs in the cache of the server (default: 256).\n");
+    fprintf(stderr, "    -j, --threads n\n");
+    fprintf(stderr, "       Divide the search over n threads (default: the number of\n");
+    fprintf(stderr, "       processors). The eOPD that is printed does not depend on n.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
 
 void usage(char *name) {
     fprintf(stderr, "Usage: %s [options] u1,v1,w1 ... un,vn,wn\n", name);
+    fprintf(stderr, "       %s [options] -u path\n", name);
     fprintf(stderr, "For more information type: %s -h \n\n", name);
 }
 
@@ -463,12 +1318,35 @@ int main(int argc, char *argv[]) {
     int c, i;
     char *name = argv[0];
     static struct option long_options[] = {
-         {"help", no_argument, NULL, 'h'}
+         {"all", no_argument, NULL, 'a'},
+         {"smallest", no_argument, NULL, 's'},
+         {"socket", required_argument, NULL, 'u'},
+         {"cache", required_argument, NULL, 'c'},
+         {"threads", required_argument, NULL, 'j'},
+         {"help", no_argument, NULL, 'h'},
+         {NULL, 0, NULL, 0}
     };
     int option_index = 0;
+    
+    char *socketPath = NULL;
 
-    while ((c = getopt_long(argc, argv, "h", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "asu:c:j:h", long_options, &option_index)) != -1) {
         switch (c) {
+            case 'a':
+                witnessMode = ALL_WITNESSES;
+                break;
+            case 's':
+                witnessMode = SMALLEST_WITNESS;
+                break;
+            case 'u':
+                socketPath = optarg;
+                break;
+            case 'c':
+                graphCacheSize = atoi(optarg);
+                break;
+            case 'j':
+                threadCount = atoi(optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -482,35 +1360,30 @@ int main(int argc, char *argv[]) {
         }
     }
     
-    if(argc - optind < 2){
+    if(socketPath == NULL && argc - optind < 2){
         usage(name);
         return EXIT_FAILURE;
     }
     
-    bitset tuple = EMPTY_SET;
+    if(graphCacheSize < 1){
+        fprintf(stderr, "The graph cache should contain at least 1 graph -- exiting!\n");
+        return EXIT_FAILURE;
+    }
     
-    for(i = optind; i < argc; i++){
-        int t1, t2, t3;
-        if(sscanf(argv[i], "%d,%d,%d", &t1, &t2, &t3)!=3){
-            fprintf(stderr, "Error while reading triangle %d.\n", i - optind + 1);
-            usage(name);
-            return EXIT_FAILURE;
-        }
-        bitset triangle = EMPTY_SET;
-        ADD(triangle, t1-1);
-        ADD(triangle, t2-1);
-        ADD(triangle, t3-1);
-        int j=0;
-        while(j < nf && CONTAINS_ALL(faceSets[j], triangle)){
-            j++;
-        }
-        if(j == nf){
-            fprintf(stderr, "The triangle %d,%d,%d does not exist -- exiting!\n", t1, t2, t3);
-            return EXIT_FAILURE;
-        } else {
-            ADD(tuple, j);
-        }
+    if(threadCount < 1){
+        threadCount = sysconf(_SC_NPROCESSORS_ONLN);
     }
+    if(threadCount < 1){
+        threadCount = 1;
+    } else if(threadCount > MAX_THREADS){
+        threadCount = MAX_THREADS;
+    }
+    
+    if(socketPath != NULL){
+        return runServer(socketPath);
+    }
+    
+    bitset tuple = EMPTY_SET;
 
     /*=========== read planar graphs ===========*/
 
@@ -522,12 +1395,39 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Error while reading triangulation -- exiting!\n");
         return EXIT_FAILURE;
     }
-    
+
+    for(i = optind; i < argc; i++){
+        int t1, t2, t3;
+        int face = readFace(argv[i], &t1, &t2, &t3);
+        if(face == -1){
+            fprintf(stderr, "Error while reading triangle %d.\n", i - optind + 1);
+            usage(name);
+            return EXIT_FAILURE;
+        } else if(face == -2){
+            fprintf(stderr, "The triangle %d,%d,%d does not exist -- exiting!\n", t1, t2, t3);
+            return EXIT_FAILURE;
+        } else {
+            ADD(tuple, face);
+        }
+    }
+
     if(findEOPD(tuple)){
+        if(witnessMode == ALL_WITNESSES){
+            printWitnesses();
+        } else {
+            printFaceTupleFaces(eopdFaces);
+        }
         fprintf(stderr, "There is an extended outer planar disc.\n");
     } else {
+        if(witnessMode == ALL_WITNESSES){
+            printWitnesses();
+        }
         fprintf(stderr, "There is no extended outer planar disc.\n");
     }
+    if(witnessMode != FIRST_WITNESS){
+        fprintf(stderr, "Visited %llu search state%s.\n",
+                numberOfVisitedStates, numberOfVisitedStates==1 ? "" : "s");
+    }
     
     return EXIT_SUCCESS;
 }
@@ -7,12 +7,14 @@
 
 /* This program reads a plane triangulations from standard in and
  * looks for an extended outer planar disc which contains 2 faces
- * of the specified tuple.   
+ * of the specified tuple. Alternatively it estimates the fraction of
+ * 4-tuples of vertex-disjoint faces that are not covered by an eOPD
+ * by checking random tuples.
  * 
  * 
  * Compile with:
  *     
- *     cc -o find_eopd_4_tuple_large -O4 find_eopd_4_tuple_large.c
+ *     cc -o find_eopd_4_tuple_large -O4 -pthread find_eopd_4_tuple_large.c -lm
  * 
  */
 
@@ -20,6 +22,9 @@
 #include <stdio.h>
 #include <getopt.h>
 #include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
 
 
 #define MAXN 100            /* the maximum number of vertices */
@@ -78,6 +83,11 @@ int nv;
 int ne;
 int nf;
 
+boolean printEopd = TRUE; //print the faces of the eOPD that is found
+
+unsigned long long int numberOfNodes = 0; //nodes in the search from the extension;
+                                          //depends on the number of threads
+
 //////////////////////////////////////////////////////////////////////////////
 
 ////////START DEBUGGING METHODS
@@ -184,13 +194,206 @@ void copySet(bitset copy, bitset original){
     }
 }
 
+//=============== Bidirectional search ===========================
+
+/* For two faces that are far apart, the search from the extension only
+ * reaches the other face after many levels. With --bidirectional d,
+ * strips of at most d faces are first grown from each face of the tuple
+ * in the same way, and the search from the extension stops as soon as its
+ * disc can be joined with one of these strips along an edge. The strips
+ * are stored for the edges along which they can be joined.
+ */
+typedef struct {
+    int target; /* the face of the tuple from which the strip was grown */
+    int face; /* the last face of the strip */
+    int parent; /* the strip without its last face, or -1 */
+    bitset vertices;
+} STRIP;
+
+typedef struct {
+    int strip;
+    int next; /* the next join on the same edge, or -1 */
+    bitset outerNeighbours; /* neighbours of the vertices of the strip that
+                               are not on the edge */
+} JOIN;
+
+int stripDepth = 0; //0 means that the search is one-sided
+STRIP *strips = NULL;
+int stripCount = 0;
+int stripCapacity = 0;
+JOIN *joins = NULL;
+int joinCount = 0;
+int joinCapacity = 0;
+int firstJoin[MAXE]; /* the first join along edges[i], or -1 */
+
+void *growArray(void *array, int *capacity, size_t size){
+    *capacity = *capacity ? 2 * *capacity : 1024;
+    array = realloc(array, *capacity * size);
+    if(array == NULL){
+        fprintf(stderr, "Insufficient memory for the strips -- exiting!\n");
+        exit(1);
+    }
+    return array;
+}
+
+int storeStrip(int target, int face, int parent, bitset vertices){
+    if(stripCount == stripCapacity){
+        strips = growArray(strips, &stripCapacity, sizeof(STRIP));
+    }
+    strips[stripCount].target = target;
+    strips[stripCount].face = face;
+    strips[stripCount].parent = parent;
+    copySet(strips[stripCount].vertices, vertices);
+    return stripCount++;
+}
+
+/* Stores that strip can be joined with a disc along edge, which has the
+ * last face of the strip on its left.
+ */
+void storeJoin(int strip, EDGE *edge){
+    int i, j;
+    if(joinCount == joinCapacity){
+        joins = growArray(joins, &joinCapacity, sizeof(JOIN));
+    }
+    JOIN *join = joins + joinCount;
+    for(i = 0; i < MAXF; i++){
+        join->outerNeighbours[i] = FALSE;
+    }
+    for(i = 0; i < nv; i++){
+        if(strips[strip].vertices[i] && !edge->vertices[i]){
+            for(j = 0; j < nv; j++){
+                if(neighbourhood[i][j] && !edge->vertices[j]){
+                    join->outerNeighbours[j] = TRUE;
+                }
+            }
+        }
+    }
+    join->strip = strip;
+    join->next = firstJoin[edge - edges];
+    firstJoin[edge - edges] = joinCount++;
+}
+
+void growStrips(int strip, EDGE *lastExtendedEdge, int depth){
+    int i;
+    EDGE *extensions[2];
+    extensions[0] = lastExtendedEdge->next;
+    extensions[1] = lastExtendedEdge->inverse->prev->inverse;
+    for(i = 0; i < 2; i++){
+        EDGE *extension = extensions[i];
+        storeJoin(strip, extension);
+        if(depth > 1 && intersectionIs(strips[strip].vertices,
+                neighbourhood[extension->next->end], extension->vertices)){
+            bitset vertexUnion;
+            setUnion(vertexUnion, strips[strip].vertices, faceSets[extension->rightface]);
+            growStrips(storeStrip(strips[strip].target, extension->rightface, strip, vertexUnion),
+                    extension, depth - 1);
+        }
+    }
+}
+
+/* Grows the strips of at most stripDepth faces from each face of the
+ * tuple. The strip that only contains the face of the tuple is not
+ * stored, since the search from the extension already checks that face.
+ */
+void growStripsFromTuple(bitset tuple){
+    int i, j;
+    stripCount = joinCount = 0;
+    for(i = 0; i < ne; i++){
+        firstJoin[i] = -1;
+    }
+    for(i = 0; i < nf; i++){
+        if(tuple[i]){
+            int root = storeStrip(i, i, -1, faceSets[i]);
+            EDGE *sharedEdge = facestart[i];
+            for(j = 0; j < 3; j++){
+                EDGE *extension = sharedEdge->inverse;
+                if(intersectionIs(faceSets[i], neighbourhood[extension->next->end],
+                        extension->vertices)){
+                    bitset vertexUnion;
+                    setUnion(vertexUnion, faceSets[i], faceSets[extension->rightface]);
+                    growStrips(storeStrip(i, extension->rightface, root, vertexUnion),
+                            extension, stripDepth);
+                }
+                sharedEdge = sharedEdge->next->inverse;
+            }
+        }
+    }
+}
+
+/* Returns TRUE if the disc with the given vertices and faces can be joined
+ * with a strip that was grown from one of the remaining faces, by adding
+ * the face to the right of extension. In that case the faces of the strip
+ * are added to the faces of the disc.
+ */
+boolean joinStrip(bitset currentEopdVertices, bitset currentEopdFaces, bitset remainingFaces, EDGE *extension){
+    int i, j;
+    for(i = firstJoin[extension->inverse - edges]; i != -1; i = joins[i].next){
+        STRIP *strip = strips + joins[i].strip;
+        if(remainingFaces[strip->target] &&
+                intersectionIs(currentEopdVertices, strip->vertices, extension->vertices) &&
+                !hasNonEmptyIntersection(currentEopdVertices, joins[i].outerNeighbours)){
+            for(j = joins[i].strip; j != -1; j = strips[j].parent){
+                currentEopdFaces[strips[j].face] = TRUE;
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+//=============== Searching eOPD's ===========================
+
+/* Each face of the tuple is tried as the extension, with each of its
+ * edges as the shared edge. These roots of the search are independent,
+ * and are divided over a number of threads. The roots are handed out in
+ * order, and the search from a root is abandoned as soon as an eOPD is
+ * found from a root with a smaller index. So the eOPD that is printed is
+ * always the one from the first successful root, as in a sequential
+ * search, independent of the number of threads.
+ */
+
+#define MAX_THREADS 256
+#define MAX_ROOTS (3*MAXF)
+
+int threadCount = 0;
+
+bitset searchedTuple;
+int rootExtension[MAX_ROOTS];
+EDGE *rootSharedEdge[MAX_ROOTS];
+bitset rootEopdFaces[MAX_ROOTS]; //the faces of the eOPD found from root i
+int rootCount;
+int nextRoot;
+volatile int firstSuccessfulRoot; //rootCount as long as no eOPD was found
+
+__thread int currentRoot;
+__thread unsigned long long int numberOfNodesInThread = 0;
+
 boolean findEOPD_impl(bitset currentEopdVertices, bitset currentEopdFaces, int eopdExtension, bitset remainingFaces, EDGE *lastExtendedEdge){
+    //stop if an earlier root already found an eOPD
+    if(firstSuccessfulRoot < currentRoot){
+        return FALSE;
+    }
+    
+    numberOfNodesInThread++;
+    
     //first check whether this is a covering eOPD
     if(hasNonEmptyIntersection(currentEopdFaces, remainingFaces)){
-        printFaceTupleFaces(currentEopdFaces);
+        copySet(rootEopdFaces[currentRoot], currentEopdFaces);
         return TRUE;
     }
     
+    //then check whether it can be joined with a strip from a remaining face
+    if(stripDepth > 0){
+        bitset joinedFaces;
+        copySet(joinedFaces, currentEopdFaces);
+        if(joinStrip(currentEopdVertices, joinedFaces, remainingFaces, lastExtendedEdge->next) ||
+                joinStrip(currentEopdVertices, joinedFaces, remainingFaces,
+                    lastExtendedEdge->inverse->prev->inverse)){
+            copySet(rootEopdFaces[currentRoot], joinedFaces);
+            return TRUE;
+        }
+    }
+    
     //otherwise try extending the eOPD
     EDGE *extension = lastExtendedEdge->next;
     
@@ -225,38 +428,261 @@ boolean findEOPD_impl(bitset currentEopdVertices, bitset currentEopdFaces, int e
     return FALSE;
 }
 
+void storeSuccessfulRoot(int root){
+    int first;
+    while(root < (first = firstSuccessfulRoot) &&
+            !__sync_bool_compare_and_swap(&firstSuccessfulRoot, first, root));
+}
+
+void *searchRootsInThread(void *argument){
+    int root, k;
+    (void) argument;
+    while((root = __sync_fetch_and_add(&nextRoot, 1)) < firstSuccessfulRoot){
+        currentRoot = root;
+        int i = rootExtension[root];
+        bitset remainingFaces;
+        minus(remainingFaces, searchedTuple, i);
+        //construct initial eopd
+        int neighbouringFace = rootSharedEdge[root]->inverse->rightface;
+        bitset currentEopdVertices;
+        copySet(currentEopdVertices, faceSets[neighbouringFace]);
+
+        bitset currentEopdFaces;
+        for(k = 0; k < MAXF; k++){
+            currentEopdFaces[k] = FALSE;
+        }
+        currentEopdFaces[i] = TRUE;
+        currentEopdFaces[neighbouringFace] = TRUE;
+
+        if(findEOPD_impl(currentEopdVertices, currentEopdFaces, i, remainingFaces,
+                rootSharedEdge[root]->inverse)){
+            storeSuccessfulRoot(root);
+        }
+    }
+    __sync_fetch_and_add(&numberOfNodes, numberOfNodesInThread);
+    numberOfNodesInThread = 0;
+    return NULL;
+}
+
 boolean findEOPD(bitset tuple){
     int i, j;
+    pthread_t threads[MAX_THREADS];
     
+    if(stripDepth > 0){
+        growStripsFromTuple(tuple);
+    }
+    
+    rootCount = 0;
     for(i = 0; i < nf; i++){
         if(tuple[i]){
             //try to find a eOPD with face i as extension
-            bitset remainingFaces;
-            minus(remainingFaces, tuple, i);
             //we use each edge once as a possible shared edge 
             EDGE *sharedEdge = facestart[i];
             for(j = 0; j < 3; j++){
-                //construct initial eopd
-                int neighbouringFace = sharedEdge->inverse->rightface;
-                bitset currentEopdVertices;
-                copySet(currentEopdVertices, faceSets[neighbouringFace]);
-
-                bitset currentEopdFaces;
-                int k;
-                for(k = 0; k < MAXF; k++){
-                    currentEopdFaces[k] = FALSE;
+                rootExtension[rootCount] = i;
+                rootSharedEdge[rootCount] = sharedEdge;
+                rootCount++;
+                sharedEdge = sharedEdge->next->inverse;
+            }
+        }
+    }
+    copySet(searchedTuple, tuple);
+    nextRoot = 0;
+    firstSuccessfulRoot = rootCount;
+    
+    int count = threadCount < rootCount ? threadCount : rootCount;
+    if(count <= 1){
+        searchRootsInThread(NULL);
+    } else {
+        for(i = 0; i < count; i++){
+            if(pthread_create(threads + i, NULL, searchRootsInThread, NULL)){
+                fprintf(stderr, "Could not create thread -- exiting!\n");
+                exit(1);
+            }
+        }
+        for(i = 0; i < count; i++){
+            pthread_join(threads[i], NULL);
+        }
+    }
+    
+    if(firstSuccessfulRoot == rootCount){
+        return FALSE;
+    }
+    if(printEopd){
+        printFaceTupleFaces(rootEopdFaces[firstSuccessfulRoot]);
+    }
+    return TRUE;
+}
+
+//=============== Sampling tuples ===========================
+
+/* We use splitmix64 instead of rand() so that the samples are identical
+ * on every platform.
+ */
+unsigned long long int randomState;
+
+unsigned long long int nextRandom(){
+    unsigned long long int z = (randomState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+int randomInt(int bound){
+    return (int)(nextRandom() % (unsigned long long int)bound);
+}
+
+double randomDouble(){
+    return (nextRandom() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+boolean disjointFaces[MAXF][MAXF]; /* TRUE if faces i and j share no vertex */
+int disjointFaceList[MAXF][MAXF]; /* the faces that share no vertex with face i */
+int disjointFaceCount[MAXF];
+int maximumDisjointFaceCount;
+
+void computeDisjointFaces(){
+    int i, j;
+    maximumDisjointFaceCount = 0;
+    for(i = 0; i < nf; i++){
+        disjointFaceCount[i] = 0;
+        for(j = 0; j < nf; j++){
+            disjointFaces[i][j] = !hasNonEmptyIntersection(faceSets[i], faceSets[j]);
+            if(disjointFaces[i][j]){
+                disjointFaceList[i][disjointFaceCount[i]++] = j;
+            }
+        }
+        if(disjointFaceCount[i] > maximumDisjointFaceCount){
+            maximumDisjointFaceCount = disjointFaceCount[i];
+        }
+    }
+}
+
+/* Returns TRUE if the faces in candidates contain size pairwise
+ * vertex-disjoint faces.
+ */
+boolean hasDisjointFaces(int *candidates, int candidateCount, int size){
+    int i, j;
+    int nextCandidates[MAXF];
+    if(size == 0){
+        return TRUE;
+    }
+    for(i = 0; i < candidateCount; i++){
+        int nextCandidateCount = 0;
+        for(j = i + 1; j < candidateCount; j++){
+            if(disjointFaces[candidates[i]][candidates[j]]){
+                nextCandidates[nextCandidateCount++] = candidates[j];
+            }
+        }
+        if(hasDisjointFaces(nextCandidates, nextCandidateCount, size - 1)){
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* Stores in faces a 4-tuple of pairwise vertex-disjoint faces, chosen
+ * uniformly at random. The faces are chosen one by one, each among the
+ * faces that are disjoint from the faces already chosen. This favours
+ * tuples with few choices along the way, so each tuple is accepted with
+ * a probability proportional to the product of the numbers of choices,
+ * which makes all tuples equally likely. Assumes that the graph has
+ * such a tuple.
+ */
+void sampleFaceTuple(int *faces){
+    int i, j;
+    int candidates[4][MAXF];
+    int candidateCount[4];
+    double bound = (double) maximumDisjointFaceCount * maximumDisjointFaceCount
+            * maximumDisjointFaceCount;
+    
+    while(TRUE){
+        faces[0] = randomInt(nf);
+        candidateCount[1] = disjointFaceCount[faces[0]];
+        memcpy(candidates[1], disjointFaceList[faces[0]], candidateCount[1] * sizeof(int));
+        double weight = 1.0;
+        for(i = 1; i < 4; i++){
+            if(candidateCount[i] == 0){
+                break;
+            }
+            weight *= candidateCount[i];
+            faces[i] = candidates[i][randomInt(candidateCount[i])];
+            if(i < 3){
+                candidateCount[i+1] = 0;
+                for(j = 0; j < candidateCount[i]; j++){
+                    if(disjointFaces[faces[i]][candidates[i][j]]){
+                        candidates[i+1][candidateCount[i+1]++] = candidates[i][j];
+                    }
                 }
-                currentEopdFaces[i] = TRUE;
-                currentEopdFaces[neighbouringFace] = TRUE;
+            }
+        }
+        if(i == 4 && randomDouble() * bound < weight){
+            return;
+        }
+    }
+}
 
-                if(findEOPD_impl(currentEopdVertices, currentEopdFaces, i, remainingFaces, sharedEdge->inverse)){
-                    return TRUE;
+/* Checks random 4-tuples of vertex-disjoint faces until an uncovered
+ * tuple is found or sampleCount tuples were checked, and reports the
+ * estimated fraction of uncovered tuples together with a 95% confidence
+ * interval (Wilson score interval). The uncovered tuple is written to
+ * standard out in the format of the arguments of this program.
+ */
+int sampleFaceTuples(unsigned long long int sampleCount){
+    int i, j;
+    int faces[4];
+    unsigned long long int sampled = 0, uncovered = 0;
+    
+    printEopd = FALSE;
+    computeDisjointFaces();
+    
+    int allFaces[MAXF];
+    for(i = 0; i < nf; i++){
+        allFaces[i] = i;
+    }
+    if(!hasDisjointFaces(allFaces, nf, 4)){
+        fprintf(stderr, "There are no 4 vertex-disjoint faces -- exiting!\n");
+        return EXIT_FAILURE;
+    }
+    
+    while(sampled < sampleCount && uncovered == 0){
+        bitset tuple;
+        sampleFaceTuple(faces);
+        for(i = 0; i < MAXF; i++){
+            tuple[i] = FALSE;
+        }
+        for(i = 0; i < 4; i++){
+            tuple[faces[i]] = TRUE;
+        }
+        sampled++;
+        if(!findEOPD(tuple)){
+            uncovered++;
+            for(i = 0; i < 4; i++){
+                fprintf(stdout, "%s", i ? " " : "");
+                int separator = 0;
+                for(j = 0; j < nv; j++){
+                    if(faceSets[faces[i]][j]){
+                        fprintf(stdout, "%s%d", separator++ ? "," : "", j+1);
+                    }
                 }
-                sharedEdge = sharedEdge->next->inverse;
             }
+            fprintf(stdout, "\n");
         }
     }
-    return FALSE;
+    
+    double z = 1.959964;
+    double p = (double) uncovered / sampled;
+    double denominator = 1 + z*z/sampled;
+    double centre = (p + z*z/(2*sampled)) / denominator;
+    double margin = z * sqrt(p*(1 - p)/sampled + z*z/(4.0*sampled*sampled)) / denominator;
+    
+    fprintf(stderr, "Sampled %llu tuple%s.\n", sampled, sampled==1 ? "" : "s");
+    if(uncovered){
+        fprintf(stderr, "Found a tuple without extended outer planar disc.\n");
+    }
+    fprintf(stderr, "Estimated fraction of uncovered tuples: %.6f (95%% confidence interval %.6f - %.6f).\n",
+            p, centre - margin > 0 ? centre - margin : 0.0, centre + margin < 1 ? centre + margin : 1.0);
+    return EXIT_SUCCESS;
 }
 
 //=============== Reading and decoding planarcode ===========================
@@ -508,15 +934,33 @@ int readPlanarCode(unsigned short code[], int *length, FILE *file) {
 void help(char *name) {
     fprintf(stderr, "The program %s finds an extended outer planar discs in a plane triangulation.\n\n", name);
     fprintf(stderr, "Usage\n=====\n");
-    fprintf(stderr, " %s [options] u1,v1,w1 ... un,vn,wn\n\n", name);
+    fprintf(stderr, " %s [options] u1,v1,w1 ... un,vn,wn\n", name);
+    fprintf(stderr, " %s [options] -m n\n\n", name);
     fprintf(stderr, "\nThis program can handle graphs up to %d vertices.\n\n", MAXN);
     fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -m, --samples n\n");
+    fprintf(stderr, "       Instead of checking the given tuple, check up to n random 4-tuples\n");
+    fprintf(stderr, "       of vertex-disjoint faces, and report the estimated fraction of\n");
+    fprintf(stderr, "       uncovered tuples. Stops at the first uncovered tuple, which is\n");
+    fprintf(stderr, "       written to standard out.\n");
+    fprintf(stderr, "    -s, --seed n\n");
+    fprintf(stderr, "       Seed for the random generator used by --samples (default: 1).\n");
+    fprintf(stderr, "    -b, --bidirectional d\n");
+    fprintf(stderr, "       Also grow strips of at most d faces from the faces of the tuple,\n");
+    fprintf(stderr, "       and stop as soon as the disc grown from the extension can be\n");
+    fprintf(stderr, "       joined with one of them. The number of strips grows exponentially\n");
+    fprintf(stderr, "       with d.\n");
+    fprintf(stderr, "    -j, --threads n\n");
+    fprintf(stderr, "       Divide the search for each tuple over n threads (default: the\n");
+    fprintf(stderr, "       number of processors). The eOPD that is printed does not depend\n");
+    fprintf(stderr, "       on n.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
 
 void usage(char *name) {
     fprintf(stderr, "Usage: %s [options] u1,v1,w1 ... un,vn,wn\n", name);
+    fprintf(stderr, "       %s [options] -m n\n", name);
     fprintf(stderr, "For more information type: %s -h \n\n", name);
 }
 
@@ -527,12 +971,32 @@ int main(int argc, char *argv[]) {
     int c, i;
     char *name = argv[0];
     static struct option long_options[] = {
-         {"help", no_argument, NULL, 'h'}
+         {"samples", required_argument, NULL, 'm'},
+         {"seed", required_argument, NULL, 's'},
+         {"bidirectional", required_argument, NULL, 'b'},
+         {"threads", required_argument, NULL, 'j'},
+         {"help", no_argument, NULL, 'h'},
+         {NULL, 0, NULL, 0}
     };
     int option_index = 0;
+    
+    unsigned long long int sampleCount = 0;
+    randomState = 1;
 
-    while ((c = getopt_long(argc, argv, "h", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "m:s:b:j:h", long_options, &option_index)) != -1) {
         switch (c) {
+            case 'm':
+                sampleCount = strtoull(optarg, NULL, 10);
+                break;
+            case 's':
+                randomState = strtoull(optarg, NULL, 10);
+                break;
+            case 'b':
+                stripDepth = atoi(optarg);
+                break;
+            case 'j':
+                threadCount = atoi(optarg);
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -546,11 +1010,20 @@ int main(int argc, char *argv[]) {
         }
     }
     
-    if(argc - optind < 2){
+    if(sampleCount == 0 && argc - optind < 2){
         usage(name);
         return EXIT_FAILURE;
     }
     
+    if(threadCount < 1){
+        threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if(threadCount < 1){
+        threadCount = 1;
+    } else if(threadCount > MAX_THREADS){
+        threadCount = MAX_THREADS;
+    }
+    
     bitset tuple;
     //empty set
     for(i = 0; i < MAXF; i++){
@@ -568,6 +1041,10 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
     
+    if(sampleCount > 0){
+        return sampleFaceTuples(sampleCount);
+    }
+    
     for(i = optind; i < argc; i++){
         int t1, t2, t3;
         if(sscanf(argv[i], "%d,%d,%d", &t1, &t2, &t3)!=3){
@@ -592,6 +1069,11 @@ int main(int argc, char *argv[]) {
     } else {
         fprintf(stderr, "There is no extended outer planar disc.\n");
     }
+    if(stripDepth > 0){
+        fprintf(stderr, "Grew %d strip%s from the faces of the tuple, and visited %llu node%s\n",
+                stripCount, stripCount==1 ? "" : "s", numberOfNodes, numberOfNodes==1 ? "" : "s");
+        fprintf(stderr, "in the search from the extension.\n");
+    }
     
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,152 @@
+#!/bin/sh
+#
+# Profile-guided optimization build for eopd, find_eopd_4_tuple and
+# find_eopd_4_tuple_large.
+#
+# Each program is built with instrumentation, trained on a corpus of
+# random triangulations, and rebuilt with the collected profile into
+# build/pgo. Afterwards the plain build and the profile-guided build are
+# timed on a held-out corpus that is generated with a different seed.
+#
+# Usage: sh pgo.sh
+#
+# The environment variables CC, GENERATOR and RUNS can be used to
+# override the defaults below.
+
+CC=${CC:-cc}
+CFLAGS="-O4 -Wall -pthread"
+GENERATOR=${GENERATOR:-build/random_triangulation}
+RUNS=${RUNS:-3}
+PGO_DIR=build/pgo
+PROFILE_DIR=$PGO_DIR/profile
+CORPUS_DIR=$PGO_DIR/corpus
+
+TRAIN_SEED=27
+TEST_SEED=2014
+
+# vertices:graphs for eopd
+EOPD_CORPORA="12:5000 20:3000 28:2000 34:2000"
+# vertices:queries for find_eopd_4_tuple and find_eopd_4_tuple_large
+QUERY_CORPORA="34:200 60:40"
+
+mkdir -p "$PGO_DIR" "$CORPUS_DIR"
+
+if "$CC" --version 2>/dev/null | grep -q clang; then
+    GENERATE_FLAGS="-fprofile-instr-generate=$PROFILE_DIR/%p.profraw"
+    merge_profile() {
+        llvm-profdata merge -output="$PROFILE_DIR/$1.profdata" "$PROFILE_DIR"/*.profraw || exit 1
+        rm -f "$PROFILE_DIR"/*.profraw
+    }
+    use_flags() {
+        echo "-fprofile-instr-use=$PROFILE_DIR/$1.profdata"
+    }
+else
+    GENERATE_FLAGS="-fprofile-generate -fprofile-dir=$PROFILE_DIR"
+    merge_profile() {
+        :
+    }
+    use_flags() {
+        echo "-fprofile-use -fprofile-dir=$PROFILE_DIR -fprofile-correction"
+    }
+fi
+
+now() {
+    date +%s%N
+}
+
+# generate_corpus vertices count seed
+generate_corpus() {
+    file="$CORPUS_DIR/eopd_$1_$2_$3.pc"
+    if [ ! -f "$file" ]; then
+        "$GENERATOR" -c "$2" -s "$3" "$1" > "$file" || exit 1
+    fi
+    echo "$file"
+}
+
+# generate_queries vertices count seed
+# Writes one graph per file together with a file of query tuples.
+generate_queries() {
+    dir="$CORPUS_DIR/queries_$1_$2_$3"
+    if [ ! -d "$dir" ]; then
+        mkdir -p "$dir"
+        i=0
+        while [ $i -lt "$2" ]; do
+            "$GENERATOR" -s $(($3 * 100000 + i)) -t 4 "$1" \
+                > "$dir/$i.pc" 2> "$dir/$i.tuple" || exit 1
+            i=$((i + 1))
+        done
+    fi
+    echo "$dir"
+}
+
+# run_eopd binary seed: runs eopd on all corpora for the given seed
+run_eopd() {
+    for corpus in $EOPD_CORPORA; do
+        file=$(generate_corpus "${corpus%%:*}" "${corpus##*:}" "$2")
+        "$1" < "$file" > /dev/null 2>&1
+    done
+}
+
+# run_queries binary seed: runs all queries for the given seed
+run_queries() {
+    for corpus in $QUERY_CORPORA; do
+        n=${corpus%%:*}
+        case "$1" in
+            *find_eopd_4_tuple_large*) ;;
+            *) if [ "$n" -gt 34 ]; then continue; fi ;;
+        esac
+        dir=$(generate_queries "$n" "${corpus##*:}" "$2")
+        for graph in "$dir"/*.pc; do
+            "$1" $(cat "${graph%.pc}.tuple") < "$graph" > /dev/null 2>&1
+        done
+    done
+}
+
+# time_runs binary runner seed: prints the fastest of RUNS runs in ms
+time_runs() {
+    best=""
+    run=0
+    while [ $run -lt "$RUNS" ]; do
+        start=$(now)
+        "$2" "$1" "$3"
+        elapsed=$((($(now) - start) / 1000000))
+        if [ -z "$best" ] || [ "$elapsed" -lt "$best" ]; then
+            best=$elapsed
+        fi
+        run=$((run + 1))
+    done
+    echo "$best"
+}
+
+printf "%-28s %10s %10s %8s\n" "program" "plain (ms)" "pgo (ms)" "speedup"
+
+for program in eopd find_eopd_4_tuple find_eopd_4_tuple_large; do
+    if [ "$program" = "eopd" ]; then
+        runner=run_eopd
+    else
+        runner=run_queries
+    fi
+
+    rm -rf "$PROFILE_DIR"
+    mkdir -p "$PROFILE_DIR"
+
+    # plain build for the comparison
+    "$CC" -o "$PGO_DIR/$program.plain" $CFLAGS "$program.c" -lm || exit 1
+
+    # instrumented build and training run; the instrumented binary has
+    # the same name as the final one, so that gcc finds its profile
+    "$CC" -o "$PGO_DIR/$program" $CFLAGS $GENERATE_FLAGS "$program.c" -lm || exit 1
+    $runner "$PGO_DIR/$program" $TRAIN_SEED
+    merge_profile "$program"
+
+    # optimized build
+    "$CC" -o "$PGO_DIR/$program" $CFLAGS $(use_flags "$program") "$program.c" -lm || exit 1
+
+    # comparison on the held-out corpus
+    $runner "$PGO_DIR/$program.plain" $TEST_SEED
+    plain=$(time_runs "$PGO_DIR/$program.plain" $runner $TEST_SEED)
+    pgo=$(time_runs "$PGO_DIR/$program" $runner $TEST_SEED)
+    echo "$program $plain $pgo" | awk '{
+        printf "%-28s %10d %10d %8.3f\n", $1, $2, $3, ($3 > 0 ? $2 / $3 : 0)
+    }'
+done
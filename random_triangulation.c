@@ -0,0 +1,373 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2014 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* This program generates random plane triangulations and writes them
+ * to standard out in planar_code. Each triangulation is obtained by
+ * applying random edge flips to a double wheel. The random generator
+ * is seeded explicitly, so the same options always produce the same
+ * triangulations, independent of the platform.
+ *
+ *
+ * Compile with:
+ *
+ *     cc -o random_triangulation -O4 random_triangulation.c
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <getopt.h>
+#include <string.h>
+
+
+#define MAXN 255            /* the maximum number of vertices */
+#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
+
+typedef int boolean;
+
+#define FALSE 0
+#define TRUE  1
+
+typedef struct e /* The data type used for edges */ {
+    int start; /* vertex where the edge starts */
+    int end; /* vertex where the edge ends */
+    struct e *prev; /* previous edge in clockwise direction */
+    struct e *next; /* next edge in clockwise direction */
+    struct e *inverse; /* the edge that is inverse to this one */
+} EDGE;
+
+EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
+int degree[MAXN];
+
+EDGE edges[MAXE];
+
+int nv;
+int ne;
+
+//====================== RANDOM NUMBERS =======================
+
+/* We use splitmix64 instead of rand() so that the generated corpora
+ * are identical on every platform.
+ */
+unsigned long long int randomState;
+
+unsigned long long int nextRandom(){
+    unsigned long long int z = (randomState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+int randomInt(int bound){
+    return (int)(nextRandom() % (unsigned long long int)bound);
+}
+
+//=============== Constructing triangulations ===========================
+
+/* Sets up the edges of vertex v in the given clockwise order.
+ */
+void setRotation(int v, int *neighbours, int count){
+    int i;
+    firstedge[v] = edges + ne;
+    for(i = 0; i < count; i++){
+        edges[ne + i].start = v;
+        edges[ne + i].end = neighbours[i];
+        edges[ne + i].next = edges + ne + (i + 1) % count;
+        edges[ne + i].prev = edges + ne + (i + count - 1) % count;
+        edges[ne + i].inverse = NULL;
+    }
+    degree[v] = count;
+    ne += count;
+}
+
+void matchInverses(){
+    int i, j;
+    for(i = 0; i < ne; i++){
+        if(edges[i].inverse == NULL){
+            for(j = i + 1; j < ne; j++){
+                if(edges[j].start == edges[i].end && edges[j].end == edges[i].start){
+                    edges[i].inverse = edges + j;
+                    edges[j].inverse = edges + i;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/* Constructs the double wheel on n vertices: vertices 0 and 1 are the
+ * poles and the vertices 2,...,n-1 form the rim in clockwise order
+ * around vertex 0.
+ */
+void constructDoubleWheel(int n){
+    int i;
+    int rim = n - 2;
+    int neighbours[MAXN];
+
+    nv = n;
+    ne = 0;
+
+    for(i = 0; i < rim; i++){
+        neighbours[i] = 2 + i;
+    }
+    setRotation(0, neighbours, rim);
+
+    for(i = 0; i < rim; i++){
+        neighbours[i] = 2 + rim - 1 - i;
+    }
+    setRotation(1, neighbours, rim);
+
+    for(i = 0; i < rim; i++){
+        neighbours[0] = 2 + (i + 1) % rim;
+        neighbours[1] = 0;
+        neighbours[2] = 2 + (i + rim - 1) % rim;
+        neighbours[3] = 1;
+        setRotation(2 + i, neighbours, 4);
+    }
+
+    matchInverses();
+}
+
+boolean areAdjacent(int u, int v){
+    EDGE *e, *elast;
+    e = elast = firstedge[u];
+    do {
+        if(e->end == v){
+            return TRUE;
+        }
+        e = e->next;
+    } while (e != elast);
+    return FALSE;
+}
+
+/* Replaces the edge uv by the edge ab, where uva and vub are the
+ * two faces containing uv. The two oriented edges of uv are reused
+ * for ab. Returns FALSE and leaves the triangulation unchanged if the
+ * flip would create a multiple edge or a vertex with degree 2.
+ */
+boolean flipEdge(EDGE *e){
+    EDGE *f = e->inverse;
+    int u = e->start;
+    int v = e->end;
+    int a = e->next->end;
+    int b = e->prev->end;
+
+    if(degree[u] <= 3 || degree[v] <= 3 || areAdjacent(a, b)){
+        return FALSE;
+    }
+
+    EDGE *au = e->next->inverse;
+    EDGE *bv = f->next->inverse;
+
+    //remove uv
+    e->prev->next = e->next;
+    e->next->prev = e->prev;
+    if(firstedge[u] == e){
+        firstedge[u] = e->next;
+    }
+    f->prev->next = f->next;
+    f->next->prev = f->prev;
+    if(firstedge[v] == f){
+        firstedge[v] = f->next;
+    }
+    degree[u]--;
+    degree[v]--;
+
+    //insert ab between au and av
+    e->start = a;
+    e->end = b;
+    e->prev = au;
+    e->next = au->next;
+    au->next->prev = e;
+    au->next = e;
+
+    //insert ba between bv and bu
+    f->start = b;
+    f->end = a;
+    f->prev = bv;
+    f->next = bv->next;
+    bv->next->prev = f;
+    bv->next = f;
+
+    degree[a]++;
+    degree[b]++;
+
+    return TRUE;
+}
+
+void randomFlips(int flipCount){
+    int i;
+    for(i = 0; i < flipCount; i++){
+        flipEdge(edges + randomInt(ne));
+    }
+}
+
+/* Writes k random pairwise vertex-disjoint faces to the given file in
+ * the format used by find_eopd_4_tuple, i.e., u1,v1,w1 ... uk,vk,wk.
+ * Returns FALSE if no such faces were found.
+ */
+boolean writeRandomFaceTuple(int k, FILE *file){
+    int i, attempt;
+    int faces[MAXN][3];
+    boolean used[MAXN];
+
+    for(attempt = 0; attempt < 1000; attempt++){
+        for(i = 0; i < nv; i++){
+            used[i] = FALSE;
+        }
+        for(i = 0; i < k; i++){
+            EDGE *e = edges + randomInt(ne);
+            faces[i][0] = e->start;
+            faces[i][1] = e->end;
+            faces[i][2] = e->next->end;
+            if(used[faces[i][0]] || used[faces[i][1]] || used[faces[i][2]]){
+                break;
+            }
+            used[faces[i][0]] = used[faces[i][1]] = used[faces[i][2]] = TRUE;
+        }
+        if(i == k){
+            for(i = 0; i < k; i++){
+                fprintf(file, "%s%d,%d,%d", i ? " " : "",
+                        faces[i][0] + 1, faces[i][1] + 1, faces[i][2] + 1);
+            }
+            fprintf(file, "\n");
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+//=============== Writing planarcode of graph ===========================
+
+void writePlanarCode(){
+    static int first = TRUE;
+    int i;
+    EDGE *e, *elast;
+
+    if(first){
+        first = FALSE;
+
+        fprintf(stdout, ">>planar_code<<");
+    }
+
+    //write the number of vertices
+    fputc(nv, stdout);
+
+    for(i=0; i<nv; i++){
+        e = elast = firstedge[i];
+        do {
+            fputc(e->end + 1, stdout);
+            e = e->next;
+        } while (e != elast);
+        fputc(0, stdout);
+    }
+}
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "The program %s generates random plane triangulations.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] n\n\n", name);
+    fprintf(stderr, "Writes random triangulations with n vertices to standard out in planar_code.\n");
+    fprintf(stderr, "Each triangulation is obtained by random edge flips in a double wheel.\n");
+    fprintf(stderr, "\nThis program can handle graphs from 5 up to %d vertices.\n\n", MAXN - 1);
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -c, --count n\n");
+    fprintf(stderr, "       Generate n triangulations (default: 1).\n");
+    fprintf(stderr, "    -s, --seed n\n");
+    fprintf(stderr, "       Seed for the random generator (default: 1).\n");
+    fprintf(stderr, "    -f, --flips n\n");
+    fprintf(stderr, "       Number of attempted flips per triangulation (default: 4*n*n).\n");
+    fprintf(stderr, "    -t, --tuple k\n");
+    fprintf(stderr, "       For each triangulation write k random pairwise vertex-disjoint\n");
+    fprintf(stderr, "       faces to standard error, in the format used by find_eopd_4_tuple.\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] n\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+int main(int argc, char *argv[]) {
+
+    /*=========== commandline parsing ===========*/
+
+    int c, i;
+    char *name = argv[0];
+    static struct option long_options[] = {
+         {"count", required_argument, NULL, 'c'},
+         {"seed", required_argument, NULL, 's'},
+         {"flips", required_argument, NULL, 'f'},
+         {"tuple", required_argument, NULL, 't'},
+         {"help", no_argument, NULL, 'h'},
+         {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    int count = 1;
+    unsigned long long int seed = 1;
+    int flips = -1;
+    int tupleSize = 0;
+
+    while ((c = getopt_long(argc, argv, "c:s:f:t:h", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'c':
+                count = atoi(optarg);
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'f':
+                flips = atoi(optarg);
+                break;
+            case 't':
+                tupleSize = atoi(optarg);
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(argc - optind != 1){
+        usage(name);
+        return EXIT_FAILURE;
+    }
+
+    int n = atoi(argv[optind]);
+    if(n < 5 || n >= MAXN){
+        fprintf(stderr, "Number of vertices should be between 5 and %d -- exiting!\n", MAXN - 1);
+        return EXIT_FAILURE;
+    }
+    if(flips < 0){
+        flips = 4*n*n;
+    }
+
+    randomState = seed;
+
+    for(i = 0; i < count; i++){
+        constructDoubleWheel(n);
+        randomFlips(flips);
+        writePlanarCode();
+        if(tupleSize > 0 && !writeRandomFaceTuple(tupleSize, stderr)){
+            fprintf(stderr, "Could not find %d vertex-disjoint faces -- exiting!\n", tupleSize);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
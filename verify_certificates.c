@@ -0,0 +1,815 @@
+/*
+ * Main developer: Nico Van Cleemput
+ * 
+ * Copyright (C) 2014 Nico Van Cleemput.
+ * Licensed under the GNU GPL, read the file LICENSE.txt for details.
+ */
+
+/* This program reads plane triangulations from standard in together
+ * with the certificates written by eopd, and verifies that each
+ * certificate proves that every k-tuple of pairwise vertex-disjoint
+ * faces contains 2 faces which are contained in an extended outer
+ * planar disc (by default k is 4). The eOPD's in the certificate are checked directly,
+ * so no search is needed. The graphs are verified in parallel.
+ * 
+ * 
+ * Compile with:
+ *     
+ *     cc -o verify_certificates -O4 -pthread verify_certificates.c
+ * 
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <getopt.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+
+#define MAXN 34            /* the maximum number of vertices */
+#define MAXE (6*MAXN-12)    /* the maximum number of oriented edges */
+#define MAXF (2*MAXN-4)      /* the maximum number of faces */
+#define MAXVAL (MAXN-1)  /* the maximum degree of a vertex */
+#define MAXCODELENGTH (MAXN+MAXE+3)
+
+#define BATCH_SIZE 1024 /* the number of graphs that are verified in parallel */
+
+typedef int boolean;
+
+#define FALSE 0
+#define TRUE  1
+
+typedef unsigned long long int bitset;
+
+#define ZERO 0ULL
+#define ONE 1ULL
+#define EMPTY_SET 0ULL
+#define SINGLETON(el) (ONE << (el))
+#define IS_SINGLETON(s) ((s) && (!((s) & ((s)-1))))
+#define HAS_MORE_THAN_ONE_ELEMENT(s) ((s) & ((s)-1))
+#define IS_NOT_EMPTY(s) (s)
+#define IS_EMPTY(s) (!(s))
+#define CONTAINS(s, el) ((s) & SINGLETON(el))
+#define CONTAINS_ALL(s, elements) (((s) & (elements)) == (elements))
+#define ADD(s, el) ((s) |= SINGLETON(el))
+#define ADD_ALL(s, elements) ((s) |= (elements))
+#define UNION(s1, s2) ((s1) | (s2))
+#define INTERSECTION(s1, s2) ((s1) & (s2))
+#define COMPLEMENT(s) (~(s))
+//these will only work if the element is actually in the set
+#define REMOVE(s, el) ((s) ^= SINGLETON(el))
+#define MINUS(s, el) ((s) ^ SINGLETON(el))
+//these will only work if the set is not empty
+#define FIRST_ELEMENT(s) __builtin_ctzll(s)
+#define SIZE(s) __builtin_popcountll(s)
+//all elements larger than el
+#define ABOVE(el) ((el) >= 63 ? EMPTY_SET : (~ZERO) << ((el) + 1))
+//all elements smaller than n
+#define FULL_SET(n) ((n) >= 64 ? ~ZERO : SINGLETON(n) - 1)
+
+#define MIN_TUPLE_SIZE 3
+#define MAX_TUPLE_SIZE 6
+
+
+typedef struct e /* The data type used for edges */ {
+    int start; /* vertex where the edge starts */
+    int end; /* vertex where the edge ends */
+    int rightface; /* face on the right side of the edge
+                          note: only valid if make_dual() called */
+    struct e *prev; /* previous edge in clockwise direction */
+    struct e *next; /* next edge in clockwise direction */
+    struct e *inverse; /* the edge that is inverse to this one */
+    int mark, index; /* two ints for temporary use;
+                          Only access mark via the MARK macros. */
+    bitset vertices;
+
+} EDGE;
+
+/* Each thread verifies its own graph, so all data describing the current
+ * graph is thread local.
+ */
+__thread EDGE *firstedge[MAXN]; /* pointer to arbitrary edge out of vertex i. */
+__thread int degree[MAXN];
+__thread bitset neighbourhood[MAXN];
+
+__thread EDGE *facestart[MAXF]; /* pointer to arbitrary edge of face i. */
+__thread int faceSize[MAXF]; /* pointer to arbitrary edge of face i. */
+__thread bitset faceSets[MAXF];
+__thread bitset dualNeighbours[MAXF]; /* faces that share an edge with face i */
+__thread bitset disjointFaces[MAXF]; /* faces that share no vertex with face i */
+
+__thread EDGE edges[MAXE];
+
+static __thread int markvalue = 30000;
+#define RESETMARKS {int mki; if ((markvalue += 2) > 30000) \
+       { markvalue = 2; for (mki=0;mki<MAXE;++mki) edges[mki].mark=0;}}
+#define MARK(e) (e)->mark = markvalue
+#define MARKLO(e) (e)->mark = markvalue
+#define MARKHI(e) (e)->mark = markvalue+1
+#define UNMARK(e) (e)->mark = markvalue-1
+#define ISMARKED(e) ((e)->mark >= markvalue)
+#define ISMARKEDLO(e) ((e)->mark == markvalue)
+#define ISMARKEDHI(e) ((e)->mark > markvalue)
+
+__thread int nv;
+__thread int ne;
+__thread int nf;
+
+#define NO_EXTENSION 255
+
+#define VERIFIED 0
+#define REJECTED 1
+#define UNCERTIFIED 2
+
+typedef struct {
+    unsigned long long int index; /* index of the graph in the input */
+    unsigned short code[MAXCODELENGTH];
+    int eopdCount; /* number of eOPD's in the certificate */
+    unsigned char *certificate; /* the eOPD's as read from the file */
+    int certificateCapacity;
+    int result;
+    char message[256];
+} JOB;
+
+//////////////////////////////////////////////////////////////////////////////
+
+__thread EDGE *edgeMatrix[MAXN][MAXN];
+
+int tupleSize = 4; //the size of the tuples of faces that should be covered
+
+/* Store in the rightface field of each edge the number of the face on
+   the right hand side of that edge.  Faces are numbered 0,1,....  Also
+   store in facestart[i] an example of an edge in the clockwise orientation
+   of the face boundary, and the size of the face in facesize[i], for each i.
+   Returns the number of faces. */
+void makeDual() {
+    register int i, sz;
+    register EDGE *e, *ex, *ef, *efx;
+
+    RESETMARKS;
+
+    nf = 0;
+    for (i = 0; i < nv; ++i) {
+
+        e = ex = firstedge[i];
+        do {
+            if (!ISMARKEDLO(e)) {
+                facestart[nf] = ef = efx = e;
+                faceSets[nf] = EMPTY_SET;
+                sz = 0;
+                do {
+                    ef->rightface = nf;
+                    ADD(faceSets[nf], ef->end);
+                    MARKLO(ef);
+                    ef = ef->inverse->prev;
+                    ++sz;
+                } while (ef != efx);
+                faceSize[nf] = sz;
+                ++nf;
+            }
+            e = e->next;
+        } while (e != ex);
+    }
+}
+
+void decodePlanarCode(unsigned short* code) {
+    /* complexity of method to determine inverse isn't that good, but will have to satisfy for now
+     */
+    int i, j, codePosition;
+    int edgeCounter = 0;
+    EDGE *inverse;
+
+    nv = code[0];
+    codePosition = 1;
+
+    for (i = 0; i < nv; i++) {
+        degree[i] = 0;
+        neighbourhood[i] = SINGLETON(code[codePosition] - 1);
+        firstedge[i] = edges + edgeCounter;
+        edges[edgeCounter].start = i;
+        edges[edgeCounter].end = code[codePosition] - 1;
+        edges[edgeCounter].vertices = UNION(SINGLETON(i), SINGLETON(code[codePosition] - 1));
+        edges[edgeCounter].next = edges + edgeCounter + 1;
+        if (code[codePosition] - 1 < i) {
+            inverse = edgeMatrix[code[codePosition] - 1][i];
+            edges[edgeCounter].inverse = inverse;
+            inverse->inverse = edges + edgeCounter;
+        } else {
+            edgeMatrix[i][code[codePosition] - 1] = edges + edgeCounter;
+            edges[edgeCounter].inverse = NULL;
+        }
+        edgeCounter++;
+        codePosition++;
+        for (j = 1; code[codePosition]; j++, codePosition++) {
+            if (j == MAXVAL) {
+                fprintf(stderr, "MAXVAL too small: %d\n", MAXVAL);
+                exit(0);
+            }
+            ADD(neighbourhood[i], code[codePosition] - 1);
+            edges[edgeCounter].start = i;
+            edges[edgeCounter].end = code[codePosition] - 1;
+            edges[edgeCounter].vertices = UNION(SINGLETON(i), SINGLETON(code[codePosition] - 1));
+            edges[edgeCounter].prev = edges + edgeCounter - 1;
+            edges[edgeCounter].next = edges + edgeCounter + 1;
+            if (code[codePosition] - 1 < i) {
+                inverse = edgeMatrix[code[codePosition] - 1][i];
+                edges[edgeCounter].inverse = inverse;
+                inverse->inverse = edges + edgeCounter;
+            } else {
+                edgeMatrix[i][code[codePosition] - 1] = edges + edgeCounter;
+                edges[edgeCounter].inverse = NULL;
+            }
+            edgeCounter++;
+        }
+        firstedge[i]->prev = edges + edgeCounter - 1;
+        edges[edgeCounter - 1].next = firstedge[i];
+        degree[i] = j;
+
+        codePosition++; /* read the closing 0 */
+    }
+
+    ne = edgeCounter;
+
+    makeDual();
+
+    // nv - ne/2 + nf = 2
+}
+
+/**
+ * 
+ * @param code
+ * @param length
+ * @param file
+ * @return returns 1 if a code was read and 0 otherwise. Exits in case of error.
+ */
+int readPlanarCode(unsigned short code[], int *length, FILE *file) {
+    static int first = 1;
+    unsigned char c;
+    char testheader[20];
+    int bufferSize, zeroCounter;
+    
+    int readCount;
+
+
+    if (first) {
+        first = 0;
+
+        if (fread(&testheader, sizeof (unsigned char), 13, file) != 13) {
+            fprintf(stderr, "can't read header ((1)file too small)-- exiting\n");
+            exit(1);
+        }
+        testheader[13] = 0;
+        if (strcmp(testheader, ">>planar_code") == 0) {
+
+        } else {
+            fprintf(stderr, "No planarcode header detected -- exiting!\n");
+            exit(1);
+        }
+        //read reminder of header (either empty or le/be specification)
+        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
+            return FALSE;
+        }
+        while (c!='<'){
+            if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
+                return FALSE;
+            }
+        }
+        //read one more character
+        if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
+            return FALSE;
+        }
+    }
+
+    /* possibly removing interior headers -- only done for planarcode */
+    if (fread(&c, sizeof (unsigned char), 1, file) == 0) {
+        //nothing left in file
+        return (0);
+    }
+
+    if (c == '>') {
+        // could be a header, or maybe just a 62 (which is also possible for unsigned char
+        code[0] = c;
+        bufferSize = 1;
+        zeroCounter = 0;
+        code[1] = (unsigned short) getc(file);
+        if (code[1] == 0) zeroCounter++;
+        code[2] = (unsigned short) getc(file);
+        if (code[2] == 0) zeroCounter++;
+        bufferSize = 3;
+        // 3 characters were read and stored in buffer
+        if ((code[1] == '>') && (code[2] == 'p')) /*we are sure that we're dealing with a header*/ {
+            while ((c = getc(file)) != '<');
+            /* read 2 more characters: */
+            c = getc(file);
+            if (c != '<') {
+                fprintf(stderr, "Problems with header -- single '<'\n");
+                exit(1);
+            }
+            if (!fread(&c, sizeof (unsigned char), 1, file)) {
+                //nothing left in file
+                return (0);
+            }
+            bufferSize = 1;
+            zeroCounter = 0;
+        }
+    } else {
+        //no header present
+        bufferSize = 1;
+        zeroCounter = 0;
+    }
+
+    if (c != 0) /* unsigned chars would be sufficient */ {
+        code[0] = c;
+        if (code[0] > MAXN) {
+            fprintf(stderr, "Constant MAXN too small: %d > %d \n", code[0], MAXN);
+            exit(1);
+        }
+        while (zeroCounter < code[0]) {
+            code[bufferSize] = (unsigned short) getc(file);
+            if (code[bufferSize] == 0) zeroCounter++;
+            bufferSize++;
+        }
+    } else {
+        readCount = fread(code, sizeof (unsigned short), 1, file);
+        if(!readCount){
+            fprintf(stderr, "Unexpected EOF.\n");
+            exit(1);
+        }
+        if (code[0] > MAXN) {
+            fprintf(stderr, "Constant MAXN too small: %d > %d \n", code[0], MAXN);
+            exit(1);
+        }
+        bufferSize = 1;
+        zeroCounter = 0;
+        while (zeroCounter < code[0]) {
+            readCount = fread(code + bufferSize, sizeof (unsigned short), 1, file);
+            if(!readCount){
+                fprintf(stderr, "Unexpected EOF.\n");
+                exit(1);
+            }
+            if (code[bufferSize] == 0) zeroCounter++;
+            bufferSize++;
+        }
+    }
+
+    *length = bufferSize;
+    return (1);
+}
+
+
+//=============== Verifying certificates ===========================
+
+void computeFaceRelations(){
+    int i, j;
+    EDGE *e;
+    for(i = 0; i < nf; i++){
+        dualNeighbours[i] = EMPTY_SET;
+        e = facestart[i];
+        for(j = 0; j < faceSize[i]; j++){
+            ADD(dualNeighbours[i], e->inverse->rightface);
+            e = e->inverse->prev;
+        }
+    }
+    for(i = 0; i < nf; i++){
+        disjointFaces[i] = EMPTY_SET;
+        for(j = 0; j < nf; j++){
+            if(IS_EMPTY(INTERSECTION(faceSets[i], faceSets[j]))){
+                ADD(disjointFaces[i], j);
+            }
+        }
+    }
+}
+
+/* Looks for a tuple of tupleSize pairwise vertex-disjoint faces that
+ * contains no pair of faces that are partners. The first size faces of
+ * the tuple are already chosen; candidates contains the faces that can
+ * be added to them and covered the union of their partners. Returns TRUE
+ * and completes tuple if such a tuple exists.
+ */
+boolean findUncoveredTuple(bitset *partners, int *tuple, int size, bitset candidates, bitset covered){
+    candidates &= COMPLEMENT(covered);
+    if(size == tupleSize - 1){
+        if(IS_NOT_EMPTY(candidates)){
+            tuple[size] = FIRST_ELEMENT(candidates);
+            return TRUE;
+        }
+        return FALSE;
+    }
+    while(IS_NOT_EMPTY(candidates)){
+        int face = FIRST_ELEMENT(candidates);
+        REMOVE(candidates, face);
+        tuple[size] = face;
+        if(findUncoveredTuple(partners, tuple, size + 1,
+                INTERSECTION(INTERSECTION(candidates, disjointFaces[face]), ABOVE(face)),
+                UNION(covered, partners[face]))){
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* Checks whether the faces form an outer planar disc, i.e., a disc in
+ * which every vertex lies on the boundary and which has no chords. The
+ * faces form such a disc if and only if they are connected in the dual,
+ * the faces around each vertex of the disc form a single fan which is not
+ * the complete neighbourhood of the vertex, the number of faces is two
+ * less than the number of vertices and the vertices induce exactly
+ * 2n-3 edges.
+ */
+boolean isOuterPlanarDisc(bitset faces, bitset *vertices, char *message){
+    int i;
+    bitset opdVertices = EMPTY_SET;
+    for(i = 0; i < nf; i++){
+        if(CONTAINS(faces, i)){
+            ADD_ALL(opdVertices, faceSets[i]);
+        }
+    }
+    *vertices = opdVertices;
+    
+    if(SIZE(faces) != SIZE(opdVertices) - 2){
+        sprintf(message, "%d faces on %d vertices do not form an outer planar disc",
+                SIZE(faces), SIZE(opdVertices));
+        return FALSE;
+    }
+    
+    //connected in the dual
+    bitset reached = SINGLETON(FIRST_ELEMENT(faces));
+    bitset frontier = reached;
+    while(IS_NOT_EMPTY(frontier)){
+        bitset next = EMPTY_SET;
+        while(IS_NOT_EMPTY(frontier)){
+            int f = FIRST_ELEMENT(frontier);
+            REMOVE(frontier, f);
+            ADD_ALL(next, dualNeighbours[f]);
+        }
+        frontier = INTERSECTION(next, faces) & COMPLEMENT(reached);
+        ADD_ALL(reached, frontier);
+    }
+    if(reached != faces){
+        sprintf(message, "faces of OPD are not connected");
+        return FALSE;
+    }
+    
+    //one fan of faces around each vertex, and no interior vertices
+    int inducedEdges = 0;
+    for(i = 0; i < nv; i++){
+        if(CONTAINS(opdVertices, i)){
+            int changes = 0;
+            EDGE *e, *elast;
+            e = elast = firstedge[i];
+            do {
+                if((CONTAINS(faces, e->rightface) != 0) !=
+                        (CONTAINS(faces, e->next->rightface) != 0)){
+                    changes++;
+                }
+                e = e->next;
+            } while (e != elast);
+            if(changes != 2){
+                sprintf(message, "vertex %d is %s of the OPD", i+1,
+                        changes ? "a cut vertex" : "an interior vertex");
+                return FALSE;
+            }
+            inducedEdges += SIZE(INTERSECTION(neighbourhood[i], opdVertices));
+        }
+    }
+    
+    //no chords
+    if(inducedEdges != 2*(2*SIZE(opdVertices) - 3)){
+        sprintf(message, "OPD has a chord");
+        return FALSE;
+    }
+    
+    return TRUE;
+}
+
+bitset readFaces(unsigned char *data, int bytes){
+    int i;
+    bitset faces = EMPTY_SET;
+    for(i = 0; i < bytes; i++){
+        faces |= ((bitset) data[i]) << (8*i);
+    }
+    return faces;
+}
+
+void verifyJob(JOB *job){
+    int i, j;
+    bitset partners[MAXF]; //faces that are covered together with face i
+    
+    decodePlanarCode(job->code);
+    if(nf != 2*nv - 4){
+        job->result = REJECTED;
+        sprintf(job->message, "not a triangulation");
+        return;
+    }
+    computeFaceRelations();
+    
+    for(i = 0; i < nf; i++){
+        partners[i] = EMPTY_SET;
+    }
+    
+    //check each eOPD
+    int faceBytes = (nf + 7)/8;
+    for(i = 0; i < job->eopdCount; i++){
+        unsigned char *data = job->certificate + i*(faceBytes + 1);
+        bitset faces = readFaces(data, faceBytes);
+        int extension = data[faceBytes];
+        bitset vertices;
+        char reason[128];
+        
+        if(IS_EMPTY(faces) || (nf < 64 && (faces >> nf))){
+            job->result = REJECTED;
+            sprintf(job->message, "eOPD %d contains invalid faces", i+1);
+            return;
+        }
+        if(!isOuterPlanarDisc(faces, &vertices, reason)){
+            job->result = REJECTED;
+            sprintf(job->message, "eOPD %d: %s", i+1, reason);
+            return;
+        }
+        for(j = 0; j < nf; j++){
+            if(CONTAINS(faces, j)){
+                ADD_ALL(partners[j], MINUS(faces, j));
+            }
+        }
+        if(extension != NO_EXTENSION){
+            if(extension >= nf || CONTAINS(faces, extension) ||
+                    !HAS_MORE_THAN_ONE_ELEMENT(INTERSECTION(faceSets[extension], vertices))){
+                job->result = REJECTED;
+                sprintf(job->message, "eOPD %d: face %d is not an extension", i+1, extension+1);
+                return;
+            }
+            for(j = 0; j < nf; j++){
+                if(CONTAINS(faces, j)){
+                    ADD(partners[j], extension);
+                }
+            }
+            ADD_ALL(partners[extension], faces);
+        }
+    }
+    
+    //check that each k-tuple of vertex-disjoint faces contains a covered pair
+    int tuple[MAX_TUPLE_SIZE];
+    if(findUncoveredTuple(partners, tuple, 0, FULL_SET(nf), EMPTY_SET)){
+        int length = sprintf(job->message, "tuple of faces");
+        for(i = 0; i < tupleSize; i++){
+            length += sprintf(job->message + length, "%s %d", i ? "," : "", tuple[i]+1);
+        }
+        sprintf(job->message + length, " is not covered");
+        job->result = REJECTED;
+        return;
+    }
+    
+    job->result = VERIFIED;
+}
+
+//=============== Parallel verification ===========================
+
+JOB jobs[BATCH_SIZE];
+int jobCount;
+int nextJob;
+
+void *verifyJobs(void *argument){
+    int i;
+    (void) argument;
+    while((i = __sync_fetch_and_add(&nextJob, 1)) < jobCount){
+        if(jobs[i].result != UNCERTIFIED){
+            verifyJob(jobs + i);
+        }
+    }
+    return NULL;
+}
+
+void verifyBatch(int threadCount){
+    int i;
+    pthread_t threads[threadCount];
+    
+    nextJob = 0;
+    for(i = 0; i < threadCount; i++){
+        if(pthread_create(threads + i, NULL, verifyJobs, NULL)){
+            fprintf(stderr, "Could not create thread -- exiting!\n");
+            exit(1);
+        }
+    }
+    for(i = 0; i < threadCount; i++){
+        pthread_join(threads[i], NULL);
+    }
+}
+
+//=============== Reading certificates ===========================
+
+unsigned long long int readLittleEndian(int bytes, FILE *file, boolean *ok){
+    int i, c;
+    unsigned long long int value = 0;
+    for(i = 0; i < bytes; i++){
+        if((c = getc(file)) == EOF){
+            *ok = FALSE;
+            return 0;
+        }
+        value |= ((unsigned long long int) c) << (8*i);
+    }
+    *ok = TRUE;
+    return value;
+}
+
+void readCertificateHeader(FILE *file){
+    char header[21];
+    if (fread(header, sizeof (unsigned char), 20, file) != 20) {
+        fprintf(stderr, "Can't read certificate header -- exiting!\n");
+        exit(1);
+    }
+    header[20] = 0;
+    if (strcmp(header, ">>eopd_certificate<<") != 0) {
+        fprintf(stderr, "No certificate header detected -- exiting!\n");
+        exit(1);
+    }
+}
+
+/* Reads the index and the number of eOPD's of the next certificate.
+ * Returns FALSE if there are no certificates left.
+ */
+boolean readNextCertificate(FILE *file, unsigned long long int *index, int *eopdCount){
+    boolean ok;
+    *index = readLittleEndian(8, file, &ok);
+    if(!ok){
+        return FALSE;
+    }
+    *eopdCount = readLittleEndian(4, file, &ok);
+    if(!ok){
+        fprintf(stderr, "Unexpected end of certificate file -- exiting!\n");
+        exit(1);
+    }
+    return TRUE;
+}
+
+void readCertificateBody(JOB *job, int eopdCount, FILE *file){
+    //the graphs are triangulations, so the number of faces is known before decoding
+    int faceCount = 2*job->code[0] - 4;
+    int size = eopdCount * ((faceCount + 7)/8 + 1);
+    if(size > job->certificateCapacity){
+        job->certificate = realloc(job->certificate, size);
+        if(job->certificate == NULL){
+            fprintf(stderr, "Insufficient memory -- exiting!\n");
+            exit(1);
+        }
+        job->certificateCapacity = size;
+    }
+    if(fread(job->certificate, sizeof (unsigned char), size, file) != (size_t) size){
+        fprintf(stderr, "Unexpected end of certificate file -- exiting!\n");
+        exit(1);
+    }
+    job->eopdCount = eopdCount;
+}
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "The program %s verifies certificates written by eopd.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] certificates\n\n", name);
+    fprintf(stderr, "The triangulations are read from standard in. These should be the same\n");
+    fprintf(stderr, "triangulations in the same order as those given to eopd.\n");
+    fprintf(stderr, "\nThis program can handle graphs up to %d vertices.\n\n", MAXN);
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -k, --tuple-size k\n");
+    fprintf(stderr, "       Verify that the k-tuples of vertex-disjoint faces are covered\n");
+    fprintf(stderr, "       (default: 4). This should be the tuple size given to eopd.\n");
+    fprintf(stderr, "    -t, --threads n\n");
+    fprintf(stderr, "       Use n threads (default: the number of processors).\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] certificates\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+int main(int argc, char *argv[]) {
+
+    /*=========== commandline parsing ===========*/
+
+    int c, i;
+    char *name = argv[0];
+    static struct option long_options[] = {
+         {"tuple-size", required_argument, NULL, 'k'},
+         {"threads", required_argument, NULL, 't'},
+         {"help", no_argument, NULL, 'h'},
+         {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+    
+    int threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+
+    while ((c = getopt_long(argc, argv, "k:t:h", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'k':
+                tupleSize = atoi(optarg);
+                if(tupleSize < MIN_TUPLE_SIZE || tupleSize > MAX_TUPLE_SIZE){
+                    fprintf(stderr, "The tuple size should be between %d and %d.\n",
+                            MIN_TUPLE_SIZE, MAX_TUPLE_SIZE);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 't':
+                threadCount = atoi(optarg);
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+    
+    if(argc - optind != 1){
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    if(threadCount < 1){
+        threadCount = 1;
+    }
+    
+    FILE *certificateFile = fopen(argv[optind], "rb");
+    if(certificateFile == NULL){
+        fprintf(stderr, "Could not open %s -- exiting!\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    readCertificateHeader(certificateFile);
+
+    unsigned long long int numberOfGraphs = 0;
+    unsigned long long int numberOfVerifiedGraphs = 0;
+    unsigned long long int numberOfRejectedGraphs = 0;
+    unsigned long long int numberOfUncertifiedGraphs = 0;
+    
+    unsigned long long int certificateIndex;
+    int certificateEopdCount;
+    boolean hasCertificate = readNextCertificate(certificateFile,
+            &certificateIndex, &certificateEopdCount);
+
+    /*=========== read planar graphs ===========*/
+
+    int length;
+    boolean done = FALSE;
+    while (!done) {
+        jobCount = 0;
+        while (jobCount < BATCH_SIZE && 
+                readPlanarCode(jobs[jobCount].code, &length, stdin)) {
+            JOB *job = jobs + jobCount;
+            numberOfGraphs++;
+            job->index = numberOfGraphs;
+            if(hasCertificate && certificateIndex < numberOfGraphs){
+                fprintf(stderr, "Certificates are not ordered by graph index -- exiting!\n");
+                return EXIT_FAILURE;
+            }
+            if(hasCertificate && certificateIndex == numberOfGraphs){
+                readCertificateBody(job, certificateEopdCount, certificateFile);
+                job->result = REJECTED;
+                hasCertificate = readNextCertificate(certificateFile,
+                        &certificateIndex, &certificateEopdCount);
+            } else {
+                job->result = UNCERTIFIED;
+            }
+            jobCount++;
+        }
+        done = jobCount < BATCH_SIZE;
+        
+        verifyBatch(threadCount < jobCount ? threadCount : jobCount);
+        
+        for(i = 0; i < jobCount; i++){
+            if(jobs[i].result == VERIFIED){
+                numberOfVerifiedGraphs++;
+            } else if(jobs[i].result == REJECTED){
+                numberOfRejectedGraphs++;
+                fprintf(stderr, "Graph %llu: certificate rejected: %s.\n",
+                        jobs[i].index, jobs[i].message);
+            } else {
+                numberOfUncertifiedGraphs++;
+            }
+        }
+    }
+    
+    if(hasCertificate){
+        fprintf(stderr, "Certificate for graph %llu, but only %llu graph%s read -- exiting!\n",
+                certificateIndex, numberOfGraphs, numberOfGraphs==1 ? "" : "s");
+        return EXIT_FAILURE;
+    }
+    fclose(certificateFile);
+    
+    fprintf(stderr, "Read %llu graph%s.\n", numberOfGraphs, 
+                numberOfGraphs==1 ? "" : "s");
+    fprintf(stderr, "Verified %llu certificate%s.\n", numberOfVerifiedGraphs, 
+                numberOfVerifiedGraphs==1 ? "" : "s");
+    fprintf(stderr, "Rejected %llu certificate%s.\n", numberOfRejectedGraphs, 
+                numberOfRejectedGraphs==1 ? "" : "s");
+    fprintf(stderr, "%llu graph%s without certificate.\n", numberOfUncertifiedGraphs, 
+                numberOfUncertifiedGraphs==1 ? "" : "s");
+    
+    return numberOfRejectedGraphs ? EXIT_FAILURE : EXIT_SUCCESS;
+}